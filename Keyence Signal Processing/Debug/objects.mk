@@ -4,5 +4,5 @@
 
 USER_OBJS :=
 
-LIBS := -lm -lfftw3
+LIBS := -lm -lfftw3 -lpthread -lrt
 
@@ -4,13 +4,82 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../sig_process.c 
+../anc_helper.c \
+../async_helper.c \
+../batch_helper.c \
+../cic_helper.c \
+../coef_helper.c \
+../event_helper.c \
+../fft_helper.c \
+../filter_helper.c \
+../filtfilt_helper.c \
+../fir_helper.c \
+../geom_helper.c \
+../median_helper.c \
+../minmax_helper.c \
+../pipe_helper.c \
+../plan_helper.c \
+../sig_process.c \
+../quant_helper.c \
+../resamp_helper.c \
+../rt_helper.c \
+../shm_helper.c \
+../sig_support.c \
+../stft_helper.c \
+../swap_helper.c \
+../tune_helper.c 
 
 OBJS += \
-./sig_process.o 
+./anc_helper.o \
+./async_helper.o \
+./batch_helper.o \
+./cic_helper.o \
+./coef_helper.o \
+./event_helper.o \
+./fft_helper.o \
+./filter_helper.o \
+./filtfilt_helper.o \
+./fir_helper.o \
+./geom_helper.o \
+./median_helper.o \
+./minmax_helper.o \
+./pipe_helper.o \
+./plan_helper.o \
+./sig_process.o \
+./quant_helper.o \
+./resamp_helper.o \
+./rt_helper.o \
+./shm_helper.o \
+./sig_support.o \
+./stft_helper.o \
+./swap_helper.o \
+./tune_helper.o 
 
 C_DEPS += \
-./sig_process.d 
+./anc_helper.d \
+./async_helper.d \
+./batch_helper.d \
+./cic_helper.d \
+./coef_helper.d \
+./event_helper.d \
+./fft_helper.d \
+./filter_helper.d \
+./filtfilt_helper.d \
+./fir_helper.d \
+./geom_helper.d \
+./median_helper.d \
+./minmax_helper.d \
+./pipe_helper.d \
+./plan_helper.d \
+./sig_process.d \
+./quant_helper.d \
+./resamp_helper.d \
+./rt_helper.d \
+./shm_helper.d \
+./sig_support.d \
+./stft_helper.d \
+./swap_helper.d \
+./tune_helper.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -0,0 +1,231 @@
+/*
+ * anc_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: adaptive noise canceller. Machine vibration reaches every head
+ *      		 as correlated noise; a fixed low-pass can't remove it without
+ *      		 smearing real height steps. Here an adaptive FIR predicts the
+ *      		 vibration in each channel from a reference (one of the channels,
+ *      		 or an external accelerometer column) and subtracts it. Height
+ *      		 changes uncorrelated with the reference pass through.
+ *
+ *      		 NLMS costs O(taps) per channel and sample. With BLOCK > 1 the
+ *      		 gradient is summed over BLOCK samples and applied once, so the
+ *      		 weight write-back is amortised. RLS converges much faster at
+ *      		 O(taps^2); its inverse correlation matrix only depends on the
+ *      		 reference, so one matrix is shared by all channels.
+ */
+
+#include "anc_helper.h"
+
+/*
+ * function: anc_init
+ * purpose: allocates an adaptive canceller with zero weights
+ * inputs: - anc_filt * AF
+ * 		   - int ALGO (ANC_NLMS, ANC_RLS)
+ * 		   - int TAPS
+ * 		   - int REF_CH (channel used as reference, ANC_EXTERNAL: separate column)
+ * 		   - int BLOCK (NLMS samples per weight update, 1: every sample)
+ * 		   - double STEP (NLMS: step size mu in (0, 2), RLS: forgetting factor
+ * 		     lambda in (0, 1])
+ * returns: 0 - success, -1 - failure
+ */
+int anc_init(anc_filt * af, int algo, int taps, int ref_ch, int block,
+		double step) {
+	if (af == NULL || taps < 1 || ref_ch < ANC_EXTERNAL || ref_ch >= OUT_NUM
+			|| block < 1 || (algo == ANC_NLMS && (step <= 0.0 || step >= 2.0))
+			|| (algo == ANC_RLS && (step <= 0.0 || step > 1.0))
+			|| (algo != ANC_NLMS && algo != ANC_RLS)) {
+		printf("Error: anc_init invalid parameters!\n");
+		return -1;
+	}
+	memset(af, 0, sizeof(anc_filt));
+	af->algo = algo;
+	af->taps = taps;
+	af->ref_ch = ref_ch;
+	af->block = (algo == ANC_NLMS) ? block : 1;
+	af->mu = step;
+	af->lambda = step;
+
+	af->w = (double *) calloc((size_t) taps * OUT_NUM, sizeof(double));
+	af->grad = (double *) calloc((size_t) taps * OUT_NUM, sizeof(double));
+	af->hist = (double *) calloc((size_t) 2 * taps, sizeof(double));
+	if (af->w == NULL || af->grad == NULL || af->hist == NULL ) {
+		printf("Error: anc_init failed mem allocation!\n");
+		anc_free(af);
+		return -1;
+	}
+	if (algo == ANC_RLS) {
+		af->P = (double *) calloc((size_t) taps * taps, sizeof(double));
+		af->Px = (double *) malloc(sizeof(double) * taps);
+		af->k = (double *) malloc(sizeof(double) * taps);
+		if (af->P == NULL || af->Px == NULL || af->k == NULL ) {
+			printf("Error: anc_init failed mem allocation!\n");
+			anc_free(af);
+			return -1;
+		}
+		int i;
+		for (i = 0; i < taps; i++)
+			af->P[(size_t) i * taps + i] = 1.0 / ANC_RLS_DELTA;
+	}
+	return 0;
+} /* int anc_init */
+
+/*
+ * function: anc_free
+ * purpose: releases memory held by an anc_filt
+ * inputs: - anc_filt * AF
+ * returns: 0 - success, -1 - failure
+ */
+int anc_free(anc_filt * af) {
+	if (af == NULL )
+		return -1;
+	free(af->w);
+	free(af->grad);
+	free(af->hist);
+	free(af->P);
+	free(af->Px);
+	free(af->k);
+	memset(af, 0, sizeof(anc_filt));
+	return 0;
+} /* int anc_free */
+
+static double anc_dot(const double * restrict a, const double * restrict b,
+		int len) {
+	double acc = 0.0;
+	int k;
+	for (k = 0; k < len; k++)
+		acc += a[k] * b[k];
+	return acc;
+}
+
+static void anc_axpy(double * restrict y, double g, const double * restrict x,
+		int len) {
+	int k;
+	for (k = 0; k < len; k++)
+		y[k] += g * x[k];
+}
+
+// RLS gain K = P x / (lambda + x' P x), then P = (P - K (P x)') / lambda
+static void anc_rls_gain(anc_filt * af, const double * x) {
+	int L = af->taps;
+	int r;
+	for (r = 0; r < L; r++)
+		af->Px[r] = anc_dot(af->P + (size_t) r * L, x, L);
+	double denom = af->lambda + anc_dot(x, af->Px, L);
+	for (r = 0; r < L; r++)
+		af->k[r] = af->Px[r] / denom;
+	double inv = 1.0 / af->lambda;
+	for (r = 0; r < L; r++) {
+		double * row = af->P + (size_t) r * L;
+		anc_axpy(row, -af->k[r], af->Px, L);
+		int c;
+		for (c = 0; c < L; c++)
+			row[c] *= inv;
+	}
+}
+
+/*
+ * function: anc_process
+ * purpose: cancels the reference-correlated part of one sample per channel and
+ * 			adapts the weights. The reference channel itself passes through.
+ * 			INPUT and OUTPUT may alias.
+ * inputs: - anc_filt * AF
+ * 		   - sig_type INPUT
+ * 		   - double REF (used when REF_CH is ANC_EXTERNAL)
+ * 		   - sig_type OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int anc_process(anc_filt * af, sig_type input, double ref, sig_type output) {
+	if (af == NULL || af->w == NULL )
+		return -1;
+
+	int L = af->taps;
+	int j;
+	double r = (af->ref_ch == ANC_EXTERNAL) ? ref : input[af->ref_ch];
+	af->hist[af->pos] = r;
+	af->hist[af->pos + L] = r;
+	af->pos = (af->pos + 1 == L) ? 0 : af->pos + 1;
+	double * x = af->hist + af->pos;
+
+	double e[OUT_NUM];
+	for (j = 0; j < OUT_NUM; j++) {
+		double d = input[j];
+		e[j] = (j == af->ref_ch) ? d : d - anc_dot(af->w + (size_t) j * L, x, L);
+		af->in_pow[j] += ANC_METRIC_ALPHA * (d * d - af->in_pow[j]);
+		af->err_pow[j] += ANC_METRIC_ALPHA * (e[j] * e[j] - af->err_pow[j]);
+	}
+
+	double step = 0.0;
+	if (af->algo == ANC_RLS) {
+		anc_rls_gain(af, x);
+		double kk = anc_dot(af->k, af->k, L);
+		for (j = 0; j < OUT_NUM; j++) {
+			if (j == af->ref_ch)
+				continue;
+			anc_axpy(af->w + (size_t) j * L, e[j], af->k, L);
+			step += e[j] * e[j] * kk;
+		}
+	} else {
+		double g = 1.0 / (ANC_EPS + anc_dot(x, x, L));
+		for (j = 0; j < OUT_NUM; j++)
+			if (j != af->ref_ch)
+				anc_axpy(af->grad + (size_t) j * L, e[j] * g, x, L);
+		if (++af->n_grad == af->block) {
+			double mu = af->mu / af->block;
+			for (j = 0; j < OUT_NUM; j++) {
+				if (j == af->ref_ch)
+					continue;
+				double * gj = af->grad + (size_t) j * L;
+				step += mu * mu * anc_dot(gj, gj, L);
+				anc_axpy(af->w + (size_t) j * L, mu, gj, L);
+				memset(gj, 0, sizeof(double) * L);
+			}
+			af->n_grad = 0;
+		}
+	}
+	af->w_step += ANC_METRIC_ALPHA * (step - af->w_step);
+	af->n++;
+
+	for (j = 0; j < OUT_NUM; j++)
+		output[j] = e[j];
+	return 0;
+} /* int anc_process */
+
+/*
+ * function: anc_block
+ * purpose: runs anc_process over a block of samples. IN and OUT may alias.
+ * inputs: - anc_filt * AF
+ * 		   - sig_type * IN
+ * 		   - double * REF (LEN values, may be NULL unless REF_CH is ANC_EXTERNAL)
+ * 		   - sig_type * OUT
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int anc_block(anc_filt * af, sig_type * in, double * ref, sig_type * out,
+		int len) {
+	if (af == NULL || (ref == NULL && af->ref_ch == ANC_EXTERNAL))
+		return -1;
+	int n;
+	for (n = 0; n < len; n++)
+		if (anc_process(af, in[n], (ref != NULL) ? ref[n] : 0.0, out[n]) == -1)
+			return -1;
+	return 0;
+} /* int anc_block */
+
+/*
+ * function: anc_reduction
+ * purpose: smoothed noise reduction achieved on a channel,
+ * 			10 log10(input power / output power). Rises while the canceller
+ * 			converges and levels off once it has.
+ * inputs: - anc_filt * AF
+ * 		   - int CH
+ * returns: reduction in dB (0 for the reference channel)
+ */
+double anc_reduction(anc_filt * af, int ch) {
+	if (af == NULL || ch < 0 || ch >= OUT_NUM || ch == af->ref_ch
+			|| af->err_pow[ch] <= 0.0)
+		return 0.0;
+	return 10.0 * log10(af->in_pow[ch] / af->err_pow[ch]);
+} /* double anc_reduction */
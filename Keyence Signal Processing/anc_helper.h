@@ -0,0 +1,105 @@
+/*
+ * anc_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef ANC_HELPER_H_
+#define ANC_HELPER_H_
+
+#include "sig_support.c"
+
+// algorithms
+#define ANC_NLMS 0
+#define ANC_RLS 1
+
+// REF_CH value for a reference passed separately from the heads
+#define ANC_EXTERNAL -1
+
+#define ANC_EPS 1e-9
+#define ANC_RLS_DELTA 1e-2
+// smoothing of the convergence metrics, about 1 / ANC_METRIC_ALPHA samples
+#define ANC_METRIC_ALPHA 1e-3
+
+typedef struct {
+	int algo;
+	int taps;
+	int ref_ch;
+	int block;
+	double mu;
+	double lambda;
+	// weights, TAPS per channel, oldest reference sample first
+	double * w;
+	// summed NLMS gradient for block updates
+	double * grad;
+	int n_grad;
+	// reference history stored twice so the newest TAPS are contiguous
+	double * hist;
+	int pos;
+	// RLS inverse correlation matrix and scratch
+	double * P;
+	double * Px;
+	double * k;
+	// convergence metrics, exponentially smoothed
+	long n;
+	double in_pow[OUT_NUM];
+	double err_pow[OUT_NUM];
+	double w_step;
+} anc_filt;
+
+/*
+ * function: anc_init
+ * purpose: allocates an adaptive canceller with zero weights
+ * inputs: - anc_filt * AF
+ * 		   - int ALGO (ANC_NLMS, ANC_RLS)
+ * 		   - int TAPS
+ * 		   - int REF_CH (ANC_EXTERNAL: separate reference column)
+ * 		   - int BLOCK (NLMS samples per weight update)
+ * 		   - double STEP (NLMS: mu, RLS: lambda)
+ * returns: 0 - success, -1 - failure
+ */
+int anc_init(anc_filt * af, int algo, int taps, int ref_ch, int block,
+		double step);
+
+/*
+ * function: anc_free
+ * purpose: releases memory held by an anc_filt
+ * inputs: - anc_filt * AF
+ * returns: 0 - success, -1 - failure
+ */
+int anc_free(anc_filt * af);
+
+/*
+ * function: anc_process
+ * purpose: cancels the reference-correlated part of one sample per channel
+ * inputs: - anc_filt * AF
+ * 		   - sig_type INPUT
+ * 		   - double REF
+ * 		   - sig_type OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int anc_process(anc_filt * af, sig_type input, double ref, sig_type output);
+
+/*
+ * function: anc_block
+ * purpose: runs anc_process over a block of samples
+ * inputs: - anc_filt * AF
+ * 		   - sig_type * IN
+ * 		   - double * REF
+ * 		   - sig_type * OUT
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int anc_block(anc_filt * af, sig_type * in, double * ref, sig_type * out,
+		int len);
+
+/*
+ * function: anc_reduction
+ * purpose: smoothed noise reduction achieved on a channel
+ * inputs: - anc_filt * AF
+ * 		   - int CH
+ * returns: reduction in dB
+ */
+double anc_reduction(anc_filt * af, int ch);
+
+#endif /* ANC_HELPER_H_ */
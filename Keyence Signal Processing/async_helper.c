@@ -0,0 +1,484 @@
+/*
+ * async_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: single threaded event loop driving one pipeline task per
+ *      		 sensor (acquire -> filter -> spectrum -> publish) without a
+ *      		 thread per sensor or stage. A task is a small state machine that
+ *      		 yields at every block boundary:
+ *
+ *      		   AS_WAIT   polling its source for the next block
+ *      		   AS_READY  block in, waiting for the batched filter pass
+ *      		   AS_DONE   filtered, spectrum and publish follow in the same turn
+ *
+ *      		 Each turn polls every waiting source (never blocking), then
+ *      		 filters every lane group whose sensors all have a block ready in
+ *      		 one batch_fir pass, then feeds the spectra and hands blocks to
+ *      		 the callback. Sensors of a lane group (LANES consecutive
+ *      		 sensors) are expected to share a sample clock; a stalled sensor
+ *      		 holds back only its own group, and only for STALL_NS. After that
+ *      		 the late sensors are split off the group with their filter
+ *      		 history (batch_fir_split) and filtered alone with fir_block from
+ *      		 then on, while the rest carry on batched. Split sensors do not
+ *      		 rejoin. While one block is filtered the
+ *      		 sources keep filling their next ones, so acquisition overlaps
+ *      		 processing.
+ *
+ *      		 as_synth is a stand-in acquisition driver: one producer thread
+ *      		 filling a lock free ring per sensor with deterministic synthetic
+ *      		 data (as_synth_value), free running or paced at FS.
+ */
+
+#include "async_helper.h"
+
+static int64_t as_now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*
+ * function: as_init
+ * purpose: sets up the runtime for N_SENSORS sensors sharing one FIR, BLOCK
+ * 			samples per task step. FFT_LEN 0 disables the spectrum stage.
+ * inputs: - as_rt * RT
+ * 		   - int N_SENSORS
+ * 		   - int BLOCK
+ * 		   - int LANES (4, 8 or 16, sensors per batched filter group)
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * 		   - int FFT_LEN
+ * 		   - int HOP (1 .. FFT_LEN)
+ * returns: 0 - success, -1 - failure
+ */
+int as_init(as_rt * rt, int n_sensors, int block, int lanes, double * taps,
+		int len, int fft_len, int hop) {
+	if (rt == NULL || n_sensors < 1 || block < 1 || fft_len < 0
+			|| (fft_len > 0 && (fft_len < 2 || hop < 1 || hop > fft_len))) {
+		printf("Error: as_init invalid parameters!\n");
+		return -1;
+	}
+	memset(rt, 0, sizeof(as_rt));
+	rt->n_sensors = n_sensors;
+	rt->block = block;
+	rt->fft_len = fft_len;
+	rt->hop = hop;
+	rt->stall_ns = AS_STALL_NS;
+	if (batch_fir_init(&rt->bf, n_sensors, lanes, taps, len) == -1)
+		return -1;
+	rt->task = (as_task *) calloc(n_sensors, sizeof(as_task));
+	if (rt->task == NULL ) {
+		printf("Error: as_init failed mem allocation!\n");
+		as_free(rt);
+		return -1;
+	}
+	int s;
+	for (s = 0; s < n_sensors; s++) {
+		as_task * t = &rt->task[s];
+		t->in = (sig_type *) malloc(sizeof(sig_type) * block);
+		t->out = (sig_type *) malloc(sizeof(sig_type) * block);
+		if (t->in == NULL || t->out == NULL ) {
+			printf("Error: as_init failed mem allocation!\n");
+			as_free(rt);
+			return -1;
+		}
+		if (fft_len == 0)
+			continue;
+		t->frame = (sig_type *) malloc(sizeof(sig_type) * fft_len);
+		t->mag = (sig_type *) malloc(sizeof(sig_type) * (fft_len / 2 + 1));
+		if (t->frame == NULL || t->mag == NULL
+				|| spec_init(&t->sp, fft_len, fft_len) == -1) {
+			printf("Error: as_init failed setting up spectra!\n");
+			as_free(rt);
+			return -1;
+		}
+	}
+	return 0;
+} /* int as_init */
+
+/*
+ * function: as_free
+ * purpose: releases the runtime and every task
+ * inputs: - as_rt * RT
+ * returns: 0 - success, -1 - failure
+ */
+int as_free(as_rt * rt) {
+	if (rt == NULL )
+		return -1;
+	int s;
+	for (s = 0; rt->task != NULL && s < rt->n_sensors; s++) {
+		as_task * t = &rt->task[s];
+		free(t->in);
+		free(t->out);
+		free(t->frame);
+		free(t->mag);
+		spec_free(&t->sp);
+		if (t->solo)
+			fir_free(&t->ff);
+	}
+	free(rt->task);
+	batch_fir_free(&rt->bf);
+	memset(rt, 0, sizeof(as_rt));
+	return 0;
+} /* int as_free */
+
+/*
+ * function: as_set_source
+ * purpose: sets the non blocking function tasks acquire their blocks from
+ * inputs: - as_rt * RT
+ * 		   - as_poll POLL
+ * 		   - void * CTX
+ * returns: 0 - success, -1 - failure
+ */
+int as_set_source(as_rt * rt, as_poll poll, void * ctx) {
+	if (rt == NULL )
+		return -1;
+	rt->poll = poll;
+	rt->poll_ctx = ctx;
+	return 0;
+} /* int as_set_source */
+
+/*
+ * function: as_set_callback
+ * purpose: sets the function filtered blocks and spectra are published to
+ * inputs: - as_rt * RT
+ * 		   - as_cb CB
+ * 		   - void * CTX
+ * returns: 0 - success, -1 - failure
+ */
+int as_set_callback(as_rt * rt, as_cb cb, void * ctx) {
+	if (rt == NULL )
+		return -1;
+	rt->cb = cb;
+	rt->cb_ctx = ctx;
+	return 0;
+} /* int as_set_callback */
+
+/*
+ * function: as_set_stall
+ * purpose: sets how long a lane group with a block ready waits for its late
+ * 			sensors before splitting them off (AS_STALL_NS by default)
+ * inputs: - as_rt * RT
+ * 		   - int64_t STALL_NS (0: wait indefinitely)
+ * returns: 0 - success, -1 - failure
+ */
+int as_set_stall(as_rt * rt, int64_t stall_ns) {
+	if (rt == NULL || stall_ns < 0)
+		return -1;
+	rt->stall_ns = stall_ns;
+	return 0;
+} /* int as_set_stall */
+
+// batched filter pass over lane group G once all its grouped sensors have a
+// block in. A sensor still waiting STALL_NS after the first ready block of
+// the group is split off, so the others never wait on it again.
+static int as_filter_group(as_rt * rt, int g) {
+	int lanes = rt->bf.lanes;
+	int s0 = g * lanes;
+	int n = (rt->n_sensors - s0 < lanes) ? rt->n_sensors - s0 : lanes;
+	as_task * t = rt->task + s0;
+	int l, i;
+	int n_ready = 0;
+	int n_late = 0;
+	int64_t first = 0;
+	for (l = 0; l < n; l++) {
+		if (t[l].solo)
+			continue;
+		if (t[l].state == AS_READY) {
+			if (n_ready == 0 || t[l].ready_ns < first)
+				first = t[l].ready_ns;
+			n_ready++;
+		} else {
+			n_late++;
+		}
+	}
+	if (n_ready == 0)
+		return 0;
+	if (n_late > 0) {
+		if (rt->stall_ns == 0 || as_now_ns() - first < rt->stall_ns)
+			return 0;
+		for (l = 0; l < n; l++) {
+			if (t[l].solo || t[l].state == AS_READY)
+				continue;
+			if (batch_fir_split(&rt->bf, s0 + l, &t[l].ff) == -1)
+				return -1;
+			t[l].solo = 1;
+			rt->splits++;
+		}
+	}
+
+	// split sensors' lanes are fed zeros, their outputs dropped
+	for (i = 0; i < rt->block; i++) {
+		for (l = 0; l < n; l++) {
+			if (t[l].solo)
+				memset(rt->x[l], 0, sizeof(sig_type));
+			else
+				memcpy(rt->x[l], t[l].in[i], sizeof(sig_type));
+		}
+		if (batch_fir_group(&rt->bf, g, rt->x, rt->y) == -1)
+			return -1;
+		for (l = 0; l < n; l++)
+			if (!t[l].solo)
+				memcpy(t[l].out[i], rt->y[l], sizeof(sig_type));
+	}
+	for (l = 0; l < n; l++)
+		if (!t[l].solo)
+			t[l].state = AS_DONE;
+	rt->passes++;
+	rt->pass_sensors += n_ready;
+	return n_ready;
+}
+
+// slides the filtered block through the spectrum frame, publishing each frame
+static void as_spectrum(as_rt * rt, as_task * t, int s) {
+	int i = 0;
+	while (i < rt->block) {
+		int m = rt->fft_len - t->fill;
+		m = (m < rt->block - i) ? m : rt->block - i;
+		memcpy(t->frame + t->fill, t->out + i, sizeof(sig_type) * m);
+		t->fill += m;
+		i += m;
+		if (t->fill < rt->fft_len)
+			break;
+		spec_mag(&t->sp, t->frame, t->mag);
+		if (rt->cb != NULL )
+			rt->cb(rt->cb_ctx, s, AS_SPECTRUM, t->mag, rt->fft_len / 2 + 1);
+		memmove(t->frame, t->frame + rt->hop,
+				sizeof(sig_type) * (rt->fft_len - rt->hop));
+		t->fill = rt->fft_len - rt->hop;
+	}
+}
+
+/*
+ * function: as_step
+ * purpose: one turn of the event loop: acquire, batched filter, spectrum
+ * 			and publish, each task advancing at most one block
+ * inputs: - as_rt * RT
+ * returns: number of task steps taken (0: idle turn), -1 - failure
+ */
+int as_step(as_rt * rt) {
+	if (rt == NULL || rt->task == NULL || rt->poll == NULL )
+		return -1;
+	int moved = 0;
+	int s, g, r;
+
+	for (s = 0; s < rt->n_sensors; s++) {
+		as_task * t = &rt->task[s];
+		if (t->state != AS_WAIT)
+			continue;
+		if ((r = rt->poll(rt->poll_ctx, s, t->in, rt->block)) == -1)
+			return -1;
+		if (r == 1) {
+			t->state = AS_READY;
+			t->ready_ns = as_now_ns();
+			moved++;
+		}
+	}
+
+	for (s = 0; s < rt->n_sensors; s++) {
+		as_task * t = &rt->task[s];
+		if (!t->solo || t->state != AS_READY)
+			continue;
+		if (fir_block(&t->ff, t->in, t->out, rt->block) == -1)
+			return -1;
+		t->state = AS_DONE;
+		rt->solo_passes++;
+		moved++;
+	}
+
+	for (g = 0; g < rt->bf.n_groups; g++) {
+		if ((r = as_filter_group(rt, g)) == -1)
+			return -1;
+		moved += r;
+	}
+
+	for (s = 0; s < rt->n_sensors; s++) {
+		as_task * t = &rt->task[s];
+		if (t->state != AS_DONE)
+			continue;
+		if (rt->fft_len > 0)
+			as_spectrum(rt, t, s);
+		if (rt->cb != NULL )
+			rt->cb(rt->cb_ctx, s, AS_FILTERED, t->out, rt->block);
+		t->blocks++;
+		t->state = AS_WAIT;
+		moved++;
+	}
+
+	rt->turns++;
+	if (moved == 0)
+		rt->idle_turns++;
+	return moved;
+} /* int as_step */
+
+/*
+ * function: as_run
+ * purpose: runs the event loop until every sensor has published N_BLOCKS
+ * 			blocks, pausing AS_IDLE_NS whenever a turn finds nothing to do
+ * inputs: - as_rt * RT
+ * 		   - long N_BLOCKS
+ * returns: 0 - success, -1 - failure
+ */
+int as_run(as_rt * rt, long n_blocks) {
+	if (rt == NULL || rt->task == NULL )
+		return -1;
+	struct timespec idle = { 0, AS_IDLE_NS };
+	for (;;) {
+		int s;
+		for (s = 0; s < rt->n_sensors && rt->task[s].blocks >= n_blocks; s++)
+			;
+		if (s == rt->n_sensors)
+			return 0;
+		int r = as_step(rt);
+		if (r == -1)
+			return -1;
+		if (r == 0)
+			nanosleep(&idle, NULL );
+	}
+} /* int as_run */
+
+/*
+ * function: as_synth_value
+ * purpose: the synthetic sample of channel J of SENSOR at sample N: a sensor
+ * 			specific tone, deterministic noise and a 0.5 step every 5000
+ * 			samples, so filtered output and edges can be checked end to end
+ * inputs: - int SENSOR
+ * 		   - long N
+ * 		   - int J
+ * 		   - double FS
+ * returns: sample value
+ */
+double as_synth_value(int sensor, long n, int j, double fs) {
+	uint32_t h = (uint32_t) (n * 2654435761u) ^ (uint32_t) (sensor * 40503u + j * 97u);
+	h ^= h >> 15;
+	h *= 2246822519u;
+	h ^= h >> 13;
+	double noise = (h >> 8) / 16777216.0 - 0.5;
+	double tone = sin(2 * pi * (1.0 + 0.1 * sensor) * n / fs + j);
+	double step = ((n / 5000 + sensor) % 2) ? 0.5 : 0.0;
+	return 0.2 * tone + 0.02 * noise + step;
+}
+
+static void * as_synth_thread(void * arg) {
+	as_synth * sy = (as_synth *) arg;
+	long n = 0;
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	long period = (long) (1e9 * sy->block / sy->fs);
+	while (!atomic_load_explicit(&sy->stop, memory_order_relaxed)) {
+		// every sensor gets block N before any gets block N + 1
+		int s, i, j;
+		for (s = 0; s < sy->n_sensors; s++) {
+			long h = atomic_load_explicit(&sy->head[s], memory_order_relaxed);
+			while (h - atomic_load_explicit(&sy->tail[s], memory_order_acquire)
+					== sy->slots) {
+				if (atomic_load_explicit(&sy->stop, memory_order_relaxed))
+					return NULL ;
+				sched_yield();
+			}
+			sig_type * b = sy->ring
+					+ ((size_t) s * sy->slots + h % sy->slots) * sy->block;
+			for (i = 0; i < sy->block; i++)
+				for (j = 0; j < OUT_NUM; j++)
+					b[i][j] = as_synth_value(s, n + i, j, sy->fs);
+			atomic_store_explicit(&sy->head[s], h + 1, memory_order_release);
+		}
+		n += sy->block;
+		if (sy->realtime) {
+			next.tv_nsec += period;
+			while (next.tv_nsec >= 1000000000L) {
+				next.tv_nsec -= 1000000000L;
+				next.tv_sec++;
+			}
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL );
+		}
+	}
+	return NULL ;
+}
+
+/*
+ * function: as_synth_start
+ * purpose: starts the synthetic driver thread
+ * inputs: - as_synth * SY
+ * 		   - int N_SENSORS
+ * 		   - int BLOCK
+ * 		   - double FS
+ * 		   - int REALTIME (1: one block per BLOCK / FS seconds, 0: free running)
+ * 		   - int SLOTS (blocks buffered per sensor)
+ * returns: 0 - success, -1 - failure
+ */
+int as_synth_start(as_synth * sy, int n_sensors, int block, double fs,
+		int realtime, int slots) {
+	if (sy == NULL || n_sensors < 1 || block < 1 || fs <= 0.0 || slots < 1) {
+		printf("Error: as_synth_start invalid parameters!\n");
+		return -1;
+	}
+	memset(sy, 0, sizeof(as_synth));
+	sy->n_sensors = n_sensors;
+	sy->block = block;
+	sy->slots = slots;
+	sy->fs = fs;
+	sy->realtime = realtime;
+	sy->ring = (sig_type *) malloc(sizeof(sig_type) * n_sensors * slots * block);
+	sy->head = (atomic_long *) malloc(sizeof(atomic_long) * n_sensors);
+	sy->tail = (atomic_long *) malloc(sizeof(atomic_long) * n_sensors);
+	if (sy->ring == NULL || sy->head == NULL || sy->tail == NULL ) {
+		printf("Error: as_synth_start failed mem allocation!\n");
+		return -1;
+	}
+	int s;
+	for (s = 0; s < n_sensors; s++) {
+		atomic_init(&sy->head[s], 0);
+		atomic_init(&sy->tail[s], 0);
+	}
+	atomic_init(&sy->stop, 0);
+	if (pthread_create(&sy->th, NULL, as_synth_thread, sy) != 0) {
+		printf("Error: as_synth_start could not start its thread!\n");
+		return -1;
+	}
+	sy->started = 1;
+	return 0;
+} /* int as_synth_start */
+
+/*
+ * function: as_synth_poll
+ * purpose: as_poll for an as_synth (CTX), never blocks
+ * inputs: - void * CTX
+ * 		   - int SENSOR
+ * 		   - sig_type * BLOCK
+ * 		   - int LEN (the driver's block length)
+ * returns: 1 - BLOCK filled, 0 - nothing ready, -1 - failure
+ */
+int as_synth_poll(void * ctx, int sensor, sig_type * block, int len) {
+	as_synth * sy = (as_synth *) ctx;
+	if (sy == NULL || sensor < 0 || sensor >= sy->n_sensors || len != sy->block)
+		return -1;
+	long t = atomic_load_explicit(&sy->tail[sensor], memory_order_relaxed);
+	if (atomic_load_explicit(&sy->head[sensor], memory_order_acquire) == t)
+		return 0;
+	memcpy(block, sy->ring + ((size_t) sensor * sy->slots + t % sy->slots) * len,
+			sizeof(sig_type) * len);
+	atomic_store_explicit(&sy->tail[sensor], t + 1, memory_order_release);
+	return 1;
+} /* int as_synth_poll */
+
+/*
+ * function: as_synth_stop
+ * purpose: stops the driver thread and releases its rings
+ * inputs: - as_synth * SY
+ * returns: 0 - success, -1 - failure
+ */
+int as_synth_stop(as_synth * sy) {
+	if (sy == NULL )
+		return -1;
+	if (sy->started) {
+		atomic_store_explicit(&sy->stop, 1, memory_order_relaxed);
+		pthread_join(sy->th, NULL );
+	}
+	free(sy->ring);
+	free(sy->head);
+	free(sy->tail);
+	memset(sy, 0, sizeof(as_synth));
+	return 0;
+} /* int as_synth_stop */
@@ -0,0 +1,208 @@
+/*
+ * async_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef ASYNC_HELPER_H_
+#define ASYNC_HELPER_H_
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include "batch_helper.h"
+#include "plan_helper.h"
+
+// callback kinds
+#define AS_FILTERED 0
+#define AS_SPECTRUM 1
+
+// task states
+#define AS_WAIT 0
+#define AS_READY 1
+#define AS_DONE 2
+
+// pause when a turn found nothing to do
+#define AS_IDLE_NS 50000
+// default wait for a late sensor before its lane group goes on without it
+#define AS_STALL_NS 100000000L
+
+// non blocking source: 1 - BLOCK filled, 0 - nothing ready, -1 - failure
+typedef int (*as_poll)(void * ctx, int sensor, sig_type * block, int len);
+// filtered blocks (LEN samples) and spectra (LEN = fft_len / 2 + 1 bins)
+typedef void (*as_cb)(void * ctx, int sensor, int kind, sig_type * data, int len);
+
+typedef struct {
+	int state;
+	long blocks;
+	sig_type * in;
+	sig_type * out;
+	// when the block went AS_READY
+	int64_t ready_ns;
+	// split off its lane group after a stall, filtered alone by FF
+	int solo;
+	fir_filt ff;
+	// sliding spectrum: FILL samples of FRAME are in
+	int fill;
+	sig_type * frame;
+	sig_type * mag;
+	spec_plan sp;
+} as_task;
+
+typedef struct {
+	int n_sensors;
+	int block;
+	int fft_len;
+	int hop;
+	batch_fir bf;
+	// 0: a lane group waits for its late sensors indefinitely
+	int64_t stall_ns;
+	as_task * task;
+	// one sample of each sensor in a lane group
+	sig_type x[BATCH_MAX_LANES];
+	sig_type y[BATCH_MAX_LANES];
+	as_poll poll;
+	void * poll_ctx;
+	as_cb cb;
+	void * cb_ctx;
+	// statistics
+	long turns;
+	long idle_turns;
+	long passes;
+	long pass_sensors;
+	long solo_passes;
+	long splits;
+} as_rt;
+
+// stand-in acquisition driver
+typedef struct {
+	int n_sensors;
+	int block;
+	int slots;
+	double fs;
+	int realtime;
+	// [sensor][slot][block]
+	sig_type * ring;
+	// blocks written (producer) and read (consumer) per sensor
+	atomic_long * head;
+	atomic_long * tail;
+	atomic_int stop;
+	pthread_t th;
+	int started;
+} as_synth;
+
+/*
+ * function: as_init
+ * purpose: sets up the event loop runtime, one task per sensor
+ * inputs: - as_rt * RT
+ * 		   - int N_SENSORS
+ * 		   - int BLOCK
+ * 		   - int LANES (4, 8 or 16)
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * 		   - int FFT_LEN (0: no spectrum)
+ * 		   - int HOP
+ * returns: 0 - success, -1 - failure
+ */
+int as_init(as_rt * rt, int n_sensors, int block, int lanes, double * taps,
+		int len, int fft_len, int hop);
+
+/*
+ * function: as_free
+ * purpose: releases the runtime and every task
+ * inputs: - as_rt * RT
+ * returns: 0 - success, -1 - failure
+ */
+int as_free(as_rt * rt);
+
+/*
+ * function: as_set_source
+ * purpose: sets the non blocking block source
+ * inputs: - as_rt * RT
+ * 		   - as_poll POLL
+ * 		   - void * CTX
+ * returns: 0 - success, -1 - failure
+ */
+int as_set_source(as_rt * rt, as_poll poll, void * ctx);
+
+/*
+ * function: as_set_callback
+ * purpose: sets the function filtered blocks and spectra are published to
+ * inputs: - as_rt * RT
+ * 		   - as_cb CB
+ * 		   - void * CTX
+ * returns: 0 - success, -1 - failure
+ */
+int as_set_callback(as_rt * rt, as_cb cb, void * ctx);
+
+/*
+ * function: as_set_stall
+ * purpose: sets how long a lane group waits for a late sensor
+ * inputs: - as_rt * RT
+ * 		   - int64_t STALL_NS (0: wait indefinitely)
+ * returns: 0 - success, -1 - failure
+ */
+int as_set_stall(as_rt * rt, int64_t stall_ns);
+
+/*
+ * function: as_step
+ * purpose: one turn of the event loop
+ * inputs: - as_rt * RT
+ * returns: number of task steps taken (0: idle turn), -1 - failure
+ */
+int as_step(as_rt * rt);
+
+/*
+ * function: as_run
+ * purpose: runs the event loop until every sensor has published N_BLOCKS blocks
+ * inputs: - as_rt * RT
+ * 		   - long N_BLOCKS
+ * returns: 0 - success, -1 - failure
+ */
+int as_run(as_rt * rt, long n_blocks);
+
+/*
+ * function: as_synth_value
+ * purpose: synthetic sample of channel J of SENSOR at sample N
+ * inputs: - int SENSOR
+ * 		   - long N
+ * 		   - int J
+ * 		   - double FS
+ * returns: sample value
+ */
+double as_synth_value(int sensor, long n, int j, double fs);
+
+/*
+ * function: as_synth_start
+ * purpose: starts the synthetic acquisition driver
+ * inputs: - as_synth * SY
+ * 		   - int N_SENSORS
+ * 		   - int BLOCK
+ * 		   - double FS
+ * 		   - int REALTIME
+ * 		   - int SLOTS
+ * returns: 0 - success, -1 - failure
+ */
+int as_synth_start(as_synth * sy, int n_sensors, int block, double fs,
+		int realtime, int slots);
+
+/*
+ * function: as_synth_poll
+ * purpose: as_poll for an as_synth
+ * inputs: - void * CTX
+ * 		   - int SENSOR
+ * 		   - sig_type * BLOCK
+ * 		   - int LEN
+ * returns: 1 - BLOCK filled, 0 - nothing ready, -1 - failure
+ */
+int as_synth_poll(void * ctx, int sensor, sig_type * block, int len);
+
+/*
+ * function: as_synth_stop
+ * purpose: stops the synthetic driver and releases it
+ * inputs: - as_synth * SY
+ * returns: 0 - success, -1 - failure
+ */
+int as_synth_stop(as_synth * sy);
+
+#endif /* ASYNC_HELPER_H_ */
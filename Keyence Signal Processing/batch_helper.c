@@ -0,0 +1,411 @@
+/*
+ * batch_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: many identical sensors through one filter design at once. A
+ *      		 single sensor gives the FIR only OUT_NUM independent sums, too
+ *      		 few to fill vector registers. Here sensors are grouped LANES
+ *      		 (4, 8 or 16) at a time and their histories interleaved as
+ *      		 [tap][channel][lane], so every tap is one shared coefficient
+ *      		 times a contiguous OUT_NUM * LANES run: one vector lane per
+ *      		 sensor. The kernels are stamped out per lane count so the
+ *      		 compiler sees fixed trip counts.
+ *
+ *      		 The CIC decimator needs no coefficients; its integrators and
+ *      		 combs run over all sensors as one flat vector, and its droop
+ *      		 compensator is a batch_fir at the output rate.
+ *
+ *      		 Each sensor's output is identical to running fir_process /
+ *      		 cic_process on it alone: the per sensor sums are formed in the
+ *      		 same order.
+ */
+
+#include "batch_helper.h"
+
+// acc[m] += rtaps[k] * h[k][m] over one group, M = OUT_NUM * LANES
+#define BATCH_FIR_KERNEL(LANES) \
+static void batch_fir_k##LANES(const double * restrict rtaps, int len, \
+		const double * restrict h, double * restrict out) { \
+	double acc[OUT_NUM * LANES] = { 0.0 }; \
+	int k, m; \
+	for (k = 0; k < len; k++) { \
+		double c = rtaps[k]; \
+		const double * hk = h + (size_t) k * OUT_NUM * LANES; \
+		for (m = 0; m < OUT_NUM * LANES; m++) \
+			acc[m] += c * hk[m]; \
+	} \
+	memcpy(out, acc, sizeof(acc)); \
+}
+
+BATCH_FIR_KERNEL(4)
+BATCH_FIR_KERNEL(8)
+BATCH_FIR_KERNEL(16)
+
+/*
+ * function: batch_fir_init
+ * purpose: allocates interleaved FIR state for N_SENSORS sensors sharing TAPS
+ * inputs: - batch_fir * BF
+ * 		   - int N_SENSORS
+ * 		   - int LANES (4, 8 or 16; sensors per vector group)
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int batch_fir_init(batch_fir * bf, int n_sensors, int lanes, double * taps,
+		int len) {
+	if (bf == NULL || n_sensors < 1 || taps == NULL || len < 1
+			|| (lanes != 4 && lanes != 8 && lanes != 16)) {
+		printf("Error: batch_fir_init invalid parameters!\n");
+		return -1;
+	}
+	memset(bf, 0, sizeof(batch_fir));
+	bf->n_sensors = n_sensors;
+	bf->lanes = lanes;
+	bf->n_groups = (n_sensors + lanes - 1) / lanes;
+	bf->len = len;
+	bf->rtaps = (double *) malloc(sizeof(double) * len);
+	bf->pos = (int *) calloc(bf->n_groups, sizeof(int));
+	bf->hist = (double *) fftw_malloc(
+			sizeof(double) * bf->n_groups * 2 * len * OUT_NUM * lanes);
+	if (bf->rtaps == NULL || bf->pos == NULL || bf->hist == NULL ) {
+		printf("Error: batch_fir_init failed mem allocation!\n");
+		batch_fir_free(bf);
+		return -1;
+	}
+	memset(bf->hist, 0, sizeof(double) * bf->n_groups * 2 * len * OUT_NUM * lanes);
+	// reversed so the dot product walks taps and history in the same direction
+	int k;
+	for (k = 0; k < len; k++)
+		bf->rtaps[k] = taps[len - 1 - k];
+	return 0;
+} /* int batch_fir_init */
+
+/*
+ * function: batch_fir_free
+ * purpose: releases memory held by a batch_fir
+ * inputs: - batch_fir * BF
+ * returns: 0 - success, -1 - failure
+ */
+int batch_fir_free(batch_fir * bf) {
+	if (bf == NULL )
+		return -1;
+	free(bf->rtaps);
+	free(bf->pos);
+	fftw_free(bf->hist);
+	memset(bf, 0, sizeof(batch_fir));
+	return 0;
+} /* int batch_fir_free */
+
+/*
+ * function: batch_fir_group
+ * purpose: pushes one sample of the sensors in lane group G (sensors
+ * 			G * LANES onwards) and returns their filtered samples. Groups
+ * 			keep separate histories, so each may be stepped when its own
+ * 			sensors have data. IN and OUT may alias.
+ * inputs: - batch_fir * BF
+ * 		   - int G
+ * 		   - sig_type * IN (one sample per sensor of the group)
+ * 		   - sig_type * OUT
+ * returns: 0 - success, -1 - failure
+ */
+int batch_fir_group(batch_fir * bf, int g, sig_type * in, sig_type * out) {
+	if (bf == NULL || bf->hist == NULL || g < 0 || g >= bf->n_groups
+			|| in == NULL || out == NULL )
+		return -1;
+
+	int L = bf->len;
+	int V = OUT_NUM * bf->lanes;
+	int n = bf->n_sensors - g * bf->lanes;
+	n = (n < bf->lanes) ? n : bf->lanes;
+	double * hg = bf->hist + (size_t) g * 2 * L * V;
+	double * h0 = hg + (size_t) bf->pos[g] * V;
+	double * h1 = hg + (size_t) (bf->pos[g] + L) * V;
+	int l, j;
+	for (l = 0; l < bf->lanes; l++) {
+		for (j = 0; j < OUT_NUM; j++) {
+			double x = (l < n) ? in[l][j] : 0.0;
+			h0[j * bf->lanes + l] = x;
+			h1[j * bf->lanes + l] = x;
+		}
+	}
+	bf->pos[g] = (bf->pos[g] + 1 == L) ? 0 : bf->pos[g] + 1;
+
+	double acc[OUT_NUM * BATCH_MAX_LANES];
+	double * h = hg + (size_t) bf->pos[g] * V;
+	if (bf->lanes == 4)
+		batch_fir_k4(bf->rtaps, L, h, acc);
+	else if (bf->lanes == 8)
+		batch_fir_k8(bf->rtaps, L, h, acc);
+	else
+		batch_fir_k16(bf->rtaps, L, h, acc);
+	for (l = 0; l < n; l++)
+		for (j = 0; j < OUT_NUM; j++)
+			out[l][j] = acc[j * bf->lanes + l];
+	return 0;
+} /* int batch_fir_group */
+
+/*
+ * function: batch_fir_process
+ * purpose: pushes one sample of every sensor and returns every filtered sample.
+ * 			IN and OUT may alias.
+ * inputs: - batch_fir * BF
+ * 		   - sig_type * IN (N_SENSORS samples)
+ * 		   - sig_type * OUT (N_SENSORS samples)
+ * returns: 0 - success, -1 - failure
+ */
+int batch_fir_process(batch_fir * bf, sig_type * in, sig_type * out) {
+	if (bf == NULL || in == NULL || out == NULL )
+		return -1;
+	int g;
+	for (g = 0; g < bf->n_groups; g++)
+		if (batch_fir_group(bf, g, in + g * bf->lanes, out + g * bf->lanes) == -1)
+			return -1;
+	return 0;
+} /* int batch_fir_process */
+
+/*
+ * function: batch_fir_split
+ * purpose: initializes FF with the taps and current history of SENSOR, so the
+ * 			sensor can carry on alone through fir_process without a restart
+ * 			transient. BF keeps the sensor's lane, its later output is unused.
+ * inputs: - batch_fir * BF
+ * 		   - int SENSOR
+ * 		   - fir_filt * FF
+ * returns: 0 - success, -1 - failure
+ */
+int batch_fir_split(batch_fir * bf, int sensor, fir_filt * ff) {
+	if (bf == NULL || bf->hist == NULL || sensor < 0 || sensor >= bf->n_sensors
+			|| ff == NULL ) {
+		printf("Error: batch_fir_split invalid parameters!\n");
+		return -1;
+	}
+	int L = bf->len;
+	int V = OUT_NUM * bf->lanes;
+	int g = sensor / bf->lanes;
+	int l = sensor % bf->lanes;
+	// rtaps are stored reversed, fir_init reverses again
+	double * taps = (double *) malloc(sizeof(double) * L);
+	if (taps == NULL ) {
+		printf("Error: batch_fir_split failed mem allocation!\n");
+		return -1;
+	}
+	int k, j;
+	for (k = 0; k < L; k++)
+		taps[k] = bf->rtaps[L - 1 - k];
+	int err = fir_init(ff, taps, L);
+	free(taps);
+	if (err == -1)
+		return -1;
+	// both rings hold 2 * LEN entries written at pos and pos + LEN
+	double * hg = bf->hist + (size_t) g * 2 * L * V;
+	for (k = 0; k < 2 * L; k++)
+		for (j = 0; j < OUT_NUM; j++)
+			ff->hist[(size_t) k * OUT_NUM + j] = hg[(size_t) k * V + j * bf->lanes + l];
+	ff->pos = bf->pos[g];
+	return 0;
+} /* int batch_fir_split */
+
+/*
+ * function: batch_cic_init
+ * purpose: allocates CIC decimators for N_SENSORS sensors with the settings
+ * 			of cic_init, plus an optional droop compensator as cic_comp_design
+ * inputs: - batch_cic * BC
+ * 		   - int N_SENSORS
+ * 		   - int LANES (4, 8 or 16, used by the compensator)
+ * 		   - int STAGES
+ * 		   - int DECIM
+ * 		   - int DELAY
+ * 		   - double Q_SCALE
+ * 		   - double MAX_IN
+ * 		   - int COMP_LEN (odd, 0: no compensator)
+ * 		   - double F_PASS
+ * 		   - int WIN_TYPE
+ * returns: 0 - success, -1 - failure
+ */
+int batch_cic_init(batch_cic * bc, int n_sensors, int lanes, int stages,
+		int decim, int delay, double q_scale, double max_in, int comp_len,
+		double f_pass, int win_type) {
+	if (bc == NULL || n_sensors < 1)
+		return -1;
+	memset(bc, 0, sizeof(batch_cic));
+
+	// a single cic_filt validates the settings and designs the compensator
+	cic_filt cf;
+	if (cic_init(&cf, stages, decim, delay, q_scale, max_in) == -1)
+		return -1;
+	if (comp_len > 0) {
+		if (cic_comp_design(&cf, comp_len, f_pass, win_type) == -1
+				|| batch_fir_init(&bc->comp, n_sensors, lanes, cf.comp, comp_len)
+						== -1) {
+			cic_free(&cf);
+			return -1;
+		}
+		bc->has_comp = 1;
+	}
+	bc->gain = cf.gain;
+	cic_free(&cf);
+
+	bc->n_sensors = n_sensors;
+	bc->stages = stages;
+	bc->decim = decim;
+	bc->delay = delay;
+	bc->q_scale = q_scale;
+	bc->max_in = max_in;
+	size_t V = (size_t) n_sensors * OUT_NUM;
+	bc->integ = (uint64_t *) calloc(stages * V, sizeof(uint64_t));
+	bc->comb = (uint64_t *) calloc((size_t) stages * delay * V, sizeof(uint64_t));
+	bc->x = (uint64_t *) malloc(sizeof(uint64_t) * V);
+	if (bc->integ == NULL || bc->comb == NULL || bc->x == NULL ) {
+		printf("Error: batch_cic_init failed mem allocation!\n");
+		batch_cic_free(bc);
+		return -1;
+	}
+	return 0;
+} /* int batch_cic_init */
+
+/*
+ * function: batch_cic_free
+ * purpose: releases memory held by a batch_cic
+ * inputs: - batch_cic * BC
+ * returns: 0 - success, -1 - failure
+ */
+int batch_cic_free(batch_cic * bc) {
+	if (bc == NULL )
+		return -1;
+	free(bc->integ);
+	free(bc->comb);
+	free(bc->x);
+	if (bc->has_comp)
+		batch_fir_free(&bc->comp);
+	memset(bc, 0, sizeof(batch_cic));
+	return 0;
+} /* int batch_cic_free */
+
+/*
+ * function: batch_cic_process
+ * purpose: pushes one sample of every sensor. All sensors decimate in step.
+ * inputs: - batch_cic * BC
+ * 		   - sig_type * IN (N_SENSORS samples)
+ * 		   - sig_type * OUT (N_SENSORS samples, written when 1 is returned)
+ * returns: 1 - output ready, 0 - decimated away, -1 - failure
+ */
+int batch_cic_process(batch_cic * bc, sig_type * in, sig_type * out) {
+	if (bc == NULL || bc->integ == NULL )
+		return -1;
+
+	int V = bc->n_sensors * OUT_NUM;
+	double * xin = (double *) in;
+	uint64_t * x = bc->x;
+	int s, m;
+	for (m = 0; m < V; m++) {
+		double v = xin[m];
+		v = (v > bc->max_in) ? bc->max_in : (v < -bc->max_in) ? -bc->max_in : v;
+		x[m] = (uint64_t) llround(v * bc->q_scale);
+	}
+
+	// integrators, unsigned arithmetic wraps modulo 2^64 by definition
+	for (s = 0; s < bc->stages; s++) {
+		uint64_t * ig = bc->integ + (size_t) s * V;
+		for (m = 0; m < V; m++) {
+			ig[m] += x[m];
+			x[m] = ig[m];
+		}
+	}
+
+	if (++bc->phase < bc->decim)
+		return 0;
+	bc->phase = 0;
+
+	for (s = 0; s < bc->stages; s++) {
+		uint64_t * d = bc->comb + ((size_t) s * bc->delay + bc->comb_pos) * V;
+		for (m = 0; m < V; m++) {
+			uint64_t y = x[m] - d[m];
+			d[m] = x[m];
+			x[m] = y;
+		}
+	}
+	bc->comb_pos = (bc->comb_pos + 1 == bc->delay) ? 0 : bc->comb_pos + 1;
+
+	double * y = (double *) out;
+	for (m = 0; m < V; m++)
+		y[m] = (double) (int64_t) x[m] * bc->gain;
+	if (bc->has_comp && batch_fir_process(&bc->comp, out, out) == -1)
+		return -1;
+	return 1;
+} /* int batch_cic_process */
+
+/*
+ * function: batch_bench
+ * purpose: filters N_STEPS samples of N_SENSORS sensors through a LEN tap FIR,
+ * 			once with batch_fir and once with one fir_filt per sensor, and
+ * 			reports nanoseconds per sensor-sample for each and the largest
+ * 			difference between their outputs.
+ * inputs: - int N_SENSORS
+ * 		   - int LANES
+ * 		   - int LEN
+ * 		   - int N_STEPS
+ * 		   - double * NS_BATCH
+ * 		   - double * NS_SINGLE
+ * 		   - double * MAX_DIFF
+ * returns: 0 - success, -1 - failure
+ */
+int batch_bench(int n_sensors, int lanes, int len, int n_steps,
+		double * ns_batch, double * ns_single, double * max_diff) {
+	double * taps = (double *) malloc(sizeof(double) * len);
+	sig_type * in = (sig_type *) malloc(sizeof(sig_type) * n_sensors);
+	sig_type * out_b = (sig_type *) malloc(sizeof(sig_type) * n_sensors);
+	sig_type * out_s = (sig_type *) malloc(sizeof(sig_type) * n_sensors);
+	fir_filt * ff = (fir_filt *) calloc(n_sensors, sizeof(fir_filt));
+	batch_fir bf;
+	memset(&bf, 0, sizeof(bf));
+	int err = (taps == NULL || in == NULL || out_b == NULL || out_s == NULL
+			|| ff == NULL ) ? -1 : 0;
+
+	int i, s, j, n;
+	if (err == 0) {
+		for (i = 0; i < len; i++)
+			taps[i] = 1.0 / len + 0.01 * sin(i);
+		err = batch_fir_init(&bf, n_sensors, lanes, taps, len);
+		for (s = 0; s < n_sensors && err == 0; s++)
+			err = fir_init(&ff[s], taps, len);
+	}
+
+	struct timespec t0, t1;
+	double t_b = 0.0, t_s = 0.0;
+	*max_diff = 0.0;
+	for (n = 0; n < n_steps && err == 0; n++) {
+		for (s = 0; s < n_sensors; s++)
+			for (j = 0; j < OUT_NUM; j++)
+				in[s][j] = sin(0.01 * n * (s + 1) + j);
+
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		err = batch_fir_process(&bf, in, out_b);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		t_b += (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		for (s = 0; s < n_sensors && err == 0; s++)
+			err = fir_process(&ff[s], in[s], out_s[s]);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		t_s += (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+
+		for (s = 0; s < n_sensors; s++)
+			for (j = 0; j < OUT_NUM; j++)
+				if (fabs(out_b[s][j] - out_s[s][j]) > *max_diff)
+					*max_diff = fabs(out_b[s][j] - out_s[s][j]);
+	}
+	*ns_batch = t_b / ((double) n_steps * n_sensors);
+	*ns_single = t_s / ((double) n_steps * n_sensors);
+
+	if (ff != NULL )
+		for (s = 0; s < n_sensors; s++)
+			fir_free(&ff[s]);
+	batch_fir_free(&bf);
+	free(ff);
+	free(taps);
+	free(in);
+	free(out_b);
+	free(out_s);
+	return err;
+} /* int batch_bench */
@@ -0,0 +1,158 @@
+/*
+ * batch_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef BATCH_HELPER_H_
+#define BATCH_HELPER_H_
+
+#include <stdint.h>
+#include <time.h>
+#include "fir_helper.h"
+#include "cic_helper.h"
+
+#define BATCH_MAX_LANES 16
+
+typedef struct {
+	int n_sensors;
+	int lanes;
+	int n_groups;
+	int len;
+	double * rtaps;
+	// per group: 2 * LEN entries of OUT_NUM * LANES, written at pos and pos + LEN
+	double * hist;
+	// per group, groups may be stepped separately with batch_fir_group
+	int * pos;
+} batch_fir;
+
+typedef struct {
+	int n_sensors;
+	int stages;
+	int decim;
+	int delay;
+	double q_scale;
+	double max_in;
+	double gain;
+	// [stage][sensor][channel]
+	uint64_t * integ;
+	// [stage][delay][sensor][channel]
+	uint64_t * comb;
+	int comb_pos;
+	int phase;
+	uint64_t * x;
+	int has_comp;
+	batch_fir comp;
+} batch_cic;
+
+/*
+ * function: batch_fir_init
+ * purpose: allocates FIR state for N_SENSORS sensors sharing one set of taps,
+ * 			interleaved LANES sensors per vector group
+ * inputs: - batch_fir * BF
+ * 		   - int N_SENSORS
+ * 		   - int LANES (4, 8 or 16)
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int batch_fir_init(batch_fir * bf, int n_sensors, int lanes, double * taps,
+		int len);
+
+/*
+ * function: batch_fir_free
+ * purpose: releases memory held by a batch_fir
+ * inputs: - batch_fir * BF
+ * returns: 0 - success, -1 - failure
+ */
+int batch_fir_free(batch_fir * bf);
+
+/*
+ * function: batch_fir_group
+ * purpose: filters one sample of the sensors in lane group G only
+ * inputs: - batch_fir * BF
+ * 		   - int G
+ * 		   - sig_type * IN (one sample per sensor of the group)
+ * 		   - sig_type * OUT
+ * returns: 0 - success, -1 - failure
+ */
+int batch_fir_group(batch_fir * bf, int g, sig_type * in, sig_type * out);
+
+/*
+ * function: batch_fir_process
+ * purpose: filters one sample of every sensor, same result as fir_process
+ * 			per sensor
+ * inputs: - batch_fir * BF
+ * 		   - sig_type * IN (N_SENSORS samples)
+ * 		   - sig_type * OUT (N_SENSORS samples)
+ * returns: 0 - success, -1 - failure
+ */
+int batch_fir_process(batch_fir * bf, sig_type * in, sig_type * out);
+
+/*
+ * function: batch_fir_split
+ * purpose: initializes FF with the taps and history of one sensor of BF
+ * inputs: - batch_fir * BF
+ * 		   - int SENSOR
+ * 		   - fir_filt * FF
+ * returns: 0 - success, -1 - failure
+ */
+int batch_fir_split(batch_fir * bf, int sensor, fir_filt * ff);
+
+/*
+ * function: batch_cic_init
+ * purpose: allocates CIC decimators for N_SENSORS sensors, optionally with a
+ * 			COMP_LEN tap droop compensator
+ * inputs: - batch_cic * BC
+ * 		   - int N_SENSORS
+ * 		   - int LANES
+ * 		   - int STAGES
+ * 		   - int DECIM
+ * 		   - int DELAY
+ * 		   - double Q_SCALE
+ * 		   - double MAX_IN
+ * 		   - int COMP_LEN (0: none)
+ * 		   - double F_PASS
+ * 		   - int WIN_TYPE
+ * returns: 0 - success, -1 - failure
+ */
+int batch_cic_init(batch_cic * bc, int n_sensors, int lanes, int stages,
+		int decim, int delay, double q_scale, double max_in, int comp_len,
+		double f_pass, int win_type);
+
+/*
+ * function: batch_cic_free
+ * purpose: releases memory held by a batch_cic
+ * inputs: - batch_cic * BC
+ * returns: 0 - success, -1 - failure
+ */
+int batch_cic_free(batch_cic * bc);
+
+/*
+ * function: batch_cic_process
+ * purpose: pushes one sample of every sensor, same result as cic_process
+ * 			per sensor
+ * inputs: - batch_cic * BC
+ * 		   - sig_type * IN
+ * 		   - sig_type * OUT
+ * returns: 1 - output ready, 0 - decimated away, -1 - failure
+ */
+int batch_cic_process(batch_cic * bc, sig_type * in, sig_type * out);
+
+/*
+ * function: batch_bench
+ * purpose: times batch_fir against one fir_filt per sensor, in nanoseconds
+ * 			per sensor-sample, and checks their outputs agree
+ * inputs: - int N_SENSORS
+ * 		   - int LANES
+ * 		   - int LEN
+ * 		   - int N_STEPS
+ * 		   - double * NS_BATCH
+ * 		   - double * NS_SINGLE
+ * 		   - double * MAX_DIFF
+ * returns: 0 - success, -1 - failure
+ */
+int batch_bench(int n_sensors, int lanes, int len, int n_steps,
+		double * ns_batch, double * ns_single, double * max_diff);
+
+#endif /* BATCH_HELPER_H_ */
@@ -0,0 +1,251 @@
+/*
+ * cic_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: cascaded integrator-comb (recursive moving average) filter with
+ *      		 optional decimation and a short droop compensation FIR. Samples
+ *      		 are quantized to fixed point and all integrator and comb state is
+ *      		 kept in wrapping 64 bit integers, so the running sums are exact
+ *      		 and cannot drift no matter how long the stream runs.
+ */
+
+#include "cic_helper.h"
+
+/*
+ * function: cic_init
+ * purpose: allocates CIC state. The filter is STAGES cascaded boxcars of length
+ * 			DECIM * DELAY, evaluated at the decimated rate fs / DECIM.
+ * 			DECIM = 1, DELAY = L, STAGES = 1 is a plain L point moving average.
+ * 			The output, up to Q_SCALE * MAX_IN * (DECIM * DELAY) ^ STAGES
+ * 			counts, must fit the signed 64 bit state; inputs beyond MAX_IN
+ * 			are clamped to it.
+ * inputs: - cic_filt * CF
+ * 		   - int STAGES (1 .. CIC_MAX_STAGES)
+ * 		   - int DECIM
+ * 		   - int DELAY
+ * 		   - double Q_SCALE (fixed point counts per input unit)
+ * 		   - double MAX_IN (largest input magnitude)
+ * returns: 0 - success, -1 - failure
+ */
+int cic_init(cic_filt * cf, int stages, int decim, int delay, double q_scale,
+		double max_in) {
+	if (cf == NULL || stages < 1 || stages > CIC_MAX_STAGES || decim < 1
+			|| delay < 1 || q_scale <= 0.0 || !(max_in > 0.0)) {
+		printf("Error: cic_init invalid parameters!\n");
+		return -1;
+	}
+
+	// register growth is stages * log2(decim * delay) bits on top of the
+	// quantized input, plus a sign bit
+	double bits = log2(q_scale * max_in) + stages * log2((double) decim * delay);
+	if (bits > 62.0) {
+		printf("Error: cic_init output of %.1f bits exceeds 64 bit state!\n",
+				bits + 1.0);
+		return -1;
+	}
+
+	memset(cf, 0, sizeof(cic_filt));
+	cf->stages = stages;
+	cf->decim = decim;
+	cf->delay = delay;
+	cf->q_scale = q_scale;
+	cf->max_in = max_in;
+	cf->gain = 1.0 / (q_scale * pow((double) decim * delay, stages));
+
+	cf->comb = (uint64_t *) calloc((size_t) stages * delay * OUT_NUM,
+			sizeof(uint64_t));
+	if (cf->comb == NULL ) {
+		printf("Error: cic_init failed mem allocation!\n");
+		return -1;
+	}
+	return 0;
+} /* int cic_init */
+
+/*
+ * function: cic_comp_design
+ * purpose: designs a linear phase FIR run at the decimated rate that flattens the
+ * 			CIC passband droop up to F_PASS (cycles per output sample, < 0.5).
+ * 			Taps come from frequency sampling of the inverse CIC response,
+ * 			tapered by win_gen and normalised to unity DC gain.
+ * inputs: - cic_filt * CF
+ * 		   - int COMP_LEN (odd)
+ * 		   - double F_PASS
+ * 		   - int WIN_TYPE
+ * returns: 0 - success, -1 - failure
+ */
+int cic_comp_design(cic_filt * cf, int comp_len, double f_pass, int win_type) {
+	if (cf == NULL || comp_len < 3 || comp_len % 2 == 0 || f_pass <= 0.0
+			|| f_pass >= 0.5) {
+		printf("Error: cic_comp_design invalid parameters!\n");
+		return -1;
+	}
+
+	double * w = (double *) malloc(sizeof(double) * comp_len);
+	double * h = (double *) malloc(sizeof(double) * comp_len);
+	double * hist = (double *) calloc((size_t) 2 * comp_len * OUT_NUM,
+			sizeof(double));
+	if (w == NULL || h == NULL || hist == NULL ) {
+		free(w);
+		free(h);
+		free(hist);
+		printf("Error: cic_comp_design failed mem allocation!\n");
+		return -1;
+	}
+	if (win_gen(win_type, w, comp_len, 0) == -1) {
+		free(w);
+		free(h);
+		free(hist);
+		return -1;
+	}
+
+	int half = comp_len / 2;
+	double rm = (double) cf->decim * cf->delay;
+	int n, k;
+	for (n = 0; n < comp_len; n++) {
+		double acc = 0.0;
+		for (k = 0; k <= half; k++) {
+			double f = (double) k / comp_len;
+			double hd = 0.0;
+			if (f == 0.0) {
+				hd = 1.0;
+			} else if (f <= f_pass) {
+				// normalised CIC magnitude at the output rate
+				double hc = sin(pi * cf->delay * f)
+						/ (rm * sin(pi * f / cf->decim));
+				hc = pow(fabs(hc), cf->stages);
+				// cap the boost near CIC nulls
+				hd = (hc > 0.1) ? 1.0 / hc : 10.0;
+			}
+			acc += ((k == 0) ? 1.0 : 2.0) * hd * cos(2 * pi * k * (n - half) / comp_len);
+		}
+		h[n] = w[n] * acc / comp_len;
+	}
+
+	double dc = 0.0;
+	for (n = 0; n < comp_len; n++)
+		dc += h[n];
+	for (n = 0; n < comp_len; n++)
+		h[n] /= dc;
+
+	free(w);
+	free(cf->comp);
+	free(cf->comp_hist);
+	cf->comp = h;
+	cf->comp_hist = hist;
+	cf->comp_len = comp_len;
+	cf->comp_pos = 0;
+	return 0;
+} /* int cic_comp_design */
+
+/*
+ * function: cic_free
+ * purpose: releases memory held by a cic_filt
+ * inputs: - cic_filt * CF
+ * returns: 0 - success, -1 - failure
+ */
+int cic_free(cic_filt * cf) {
+	if (cf == NULL )
+		return -1;
+	free(cf->comb);
+	free(cf->comp);
+	free(cf->comp_hist);
+	cf->comb = NULL;
+	cf->comp = NULL;
+	cf->comp_hist = NULL;
+	return 0;
+} /* int cic_free */
+
+/*
+ * function: cic_process
+ * purpose: pushes one sample per channel through the integrators and, every DECIM
+ * 			samples, through the combs and compensator into OUTPUT.
+ * inputs: - cic_filt * CF
+ * 		   - sig_type INPUT
+ * 		   - sig_type OUTPUT
+ * returns: 1 - output written, 0 - sample absorbed by decimation, -1 - failure
+ */
+int cic_process(cic_filt * cf, sig_type input, sig_type output) {
+	if (cf == NULL || cf->comb == NULL )
+		return -1;
+
+	int s, j;
+	uint64_t x[OUT_NUM];
+	for (j = 0; j < OUT_NUM; j++) {
+		double v = input[j];
+		v = (v > cf->max_in) ? cf->max_in : (v < -cf->max_in) ? -cf->max_in : v;
+		x[j] = (uint64_t) llround(v * cf->q_scale);
+	}
+
+	// integrators, unsigned arithmetic wraps modulo 2^64 by definition
+	for (s = 0; s < cf->stages; s++) {
+		for (j = 0; j < OUT_NUM; j++) {
+			cf->integ[s][j] += x[j];
+			x[j] = cf->integ[s][j];
+		}
+	}
+
+	if (++cf->phase < cf->decim)
+		return 0;
+	cf->phase = 0;
+
+	// combs, each with a DELAY deep history at the output rate
+	for (s = 0; s < cf->stages; s++) {
+		uint64_t * d = cf->comb + ((size_t) s * cf->delay + cf->comb_pos) * OUT_NUM;
+		for (j = 0; j < OUT_NUM; j++) {
+			uint64_t y = x[j] - d[j];
+			d[j] = x[j];
+			x[j] = y;
+		}
+	}
+	cf->comb_pos = (cf->comb_pos + 1 == cf->delay) ? 0 : cf->comb_pos + 1;
+
+	if (cf->comp == NULL ) {
+		for (j = 0; j < OUT_NUM; j++)
+			output[j] = (double) (int64_t) x[j] * cf->gain;
+		return 1;
+	}
+
+	// compensator, history stored twice so the taps see one contiguous run
+	int L = cf->comp_len;
+	double * h0 = cf->comp_hist + (size_t) cf->comp_pos * OUT_NUM;
+	double * h1 = cf->comp_hist + (size_t) (cf->comp_pos + L) * OUT_NUM;
+	for (j = 0; j < OUT_NUM; j++) {
+		h0[j] = (double) (int64_t) x[j] * cf->gain;
+		h1[j] = h0[j];
+	}
+	cf->comp_pos = (cf->comp_pos + 1 == L) ? 0 : cf->comp_pos + 1;
+
+	double acc[OUT_NUM] = { 0.0 };
+	double * hist = cf->comp_hist + (size_t) cf->comp_pos * OUT_NUM;
+	int k;
+	for (k = 0; k < L; k++)
+		for (j = 0; j < OUT_NUM; j++)
+			acc[j] += cf->comp[L - 1 - k] * hist[k * OUT_NUM + j];
+	for (j = 0; j < OUT_NUM; j++)
+		output[j] = acc[j];
+	return 1;
+} /* int cic_process */
+
+/*
+ * function: cic_block
+ * purpose: runs cic_process over a block of input samples
+ * inputs: - cic_filt * CF
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * 		   - sig_type * OUT (room for LEN / DECIM + 1 samples)
+ * 		   - int * OUT_LEN
+ * returns: 0 - success, -1 - failure
+ */
+int cic_block(cic_filt * cf, sig_type * in, int len, sig_type * out, int * out_len) {
+	int n;
+	int m = 0;
+	for (n = 0; n < len; n++) {
+		int r = cic_process(cf, in[n], out[m]);
+		if (r == -1)
+			return -1;
+		m += r;
+	}
+	*out_len = m;
+	return 0;
+} /* int cic_block */
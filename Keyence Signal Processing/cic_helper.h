@@ -0,0 +1,94 @@
+/*
+ * cic_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef CIC_HELPER_H_
+#define CIC_HELPER_H_
+
+#include <stdint.h>
+#include "filter_helper.h"
+
+#define CIC_MAX_STAGES 6
+
+// CIC state for OUT_NUM channels. channel is the innermost index everywhere so
+// each integrator / comb step is one contiguous OUT_NUM wide vector operation.
+typedef struct {
+	int stages;
+	int decim;
+	int delay;
+	double q_scale;
+	// inputs are clamped to +-MAX_IN, the range the 64 bit state is sized for
+	double max_in;
+	double gain;
+	uint64_t integ[CIC_MAX_STAGES][OUT_NUM];
+	uint64_t * comb;
+	int comb_pos;
+	int phase;
+	int comp_len;
+	double * comp;
+	double * comp_hist;
+	int comp_pos;
+} cic_filt;
+
+/*
+ * function: cic_init
+ * purpose: allocates CIC state. The filter is STAGES cascaded boxcars of length
+ * 			DECIM * DELAY, evaluated at the decimated rate fs / DECIM.
+ * 			DECIM = 1, DELAY = L, STAGES = 1 is a plain L point moving average.
+ * inputs: - cic_filt * CF
+ * 		   - int STAGES (1 .. CIC_MAX_STAGES)
+ * 		   - int DECIM
+ * 		   - int DELAY
+ * 		   - double Q_SCALE (fixed point counts per input unit)
+ * 		   - double MAX_IN (largest input magnitude, larger inputs are clamped)
+ * returns: 0 - success, -1 - failure
+ */
+int cic_init(cic_filt * cf, int stages, int decim, int delay, double q_scale,
+		double max_in);
+
+/*
+ * function: cic_comp_design
+ * purpose: designs a short droop compensation FIR for the decimated output,
+ * 			tapered with win_gen
+ * inputs: - cic_filt * CF
+ * 		   - int COMP_LEN (odd)
+ * 		   - double F_PASS (cycles per output sample, < 0.5)
+ * 		   - int WIN_TYPE
+ * returns: 0 - success, -1 - failure
+ * Codes for int win_type: 0: Hanning, 1: Hamming, 2: Blackman, 3: Blackman-Harris
+ */
+int cic_comp_design(cic_filt * cf, int comp_len, double f_pass, int win_type);
+
+/*
+ * function: cic_free
+ * purpose: releases memory held by a cic_filt
+ * inputs: - cic_filt * CF
+ * returns: 0 - success, -1 - failure
+ */
+int cic_free(cic_filt * cf);
+
+/*
+ * function: cic_process
+ * purpose: pushes one sample per channel, producing an output every DECIM samples
+ * inputs: - cic_filt * CF
+ * 		   - sig_type INPUT
+ * 		   - sig_type OUTPUT
+ * returns: 1 - output written, 0 - sample absorbed by decimation, -1 - failure
+ */
+int cic_process(cic_filt * cf, sig_type input, sig_type output);
+
+/*
+ * function: cic_block
+ * purpose: runs cic_process over a block of input samples
+ * inputs: - cic_filt * CF
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * 		   - sig_type * OUT (room for LEN / DECIM + 1 samples)
+ * 		   - int * OUT_LEN
+ * returns: 0 - success, -1 - failure
+ */
+int cic_block(cic_filt * cf, sig_type * in, int len, sig_type * out, int * out_len);
+
+#endif /* CIC_HELPER_H_ */
@@ -0,0 +1,72 @@
+/*
+ * coef_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef COEF_HELPER_H_
+#define COEF_HELPER_H_
+
+#include "sig_support.c"
+
+// filt_verify tolerance on taps, responses and passband gain
+#define COEF_TOL 1e-9
+
+/*
+ * function: win_gen
+ * purpose: writes an N point window, symmetric (repeats over N - 1) for
+ * 			filter design or periodic (repeats over N) for spectral analysis
+ * inputs: - int WIN_TYPE (0: Hanning, 1: Hamming, 2: Blackman, 3: Blackman-Harris)
+ * 		   - double * W (N)
+ * 		   - int N
+ * 		   - int PERIODIC
+ * returns: 0 - success, -1 - failure
+ */
+int win_gen(int win_type, double * w, int n, int periodic);
+
+/*
+ * function: fir_taps
+ * purpose: designs an N tap windowed-sinc FIR with unit passband gain
+ * inputs: - double F_LOW (cutoff, or lower band edge)
+ * 		   - double F_HIGH (upper band edge, band-pass only)
+ * 		   - double FS
+ * 		   - int WIN_TYPE (0: Hanning, 1: Hamming, 2: Blackman, 3: Blackman-Harris)
+ * 		   - int FILT_TYPE (0: low-pass, 1: high-pass (odd N), 2: band-pass)
+ * 		   - double * H (N)
+ * 		   - int N
+ * returns: 0 - success, -1 - failure
+ */
+int fir_taps(double f_low, double f_high, double fs, int win_type,
+		int filt_type, double * h, int n);
+
+/*
+ * function: filt_response
+ * purpose: magnitude response of the taps H at frequency F
+ * inputs: - double * H
+ * 		   - int N
+ * 		   - double F
+ * 		   - double FS
+ * returns: |H(F)|, -1 - failure
+ */
+double filt_response(double * h, int n, double f, double fs);
+
+/*
+ * function: filt_verify
+ * purpose: designs N taps with fir_taps and with the textbook formulas, and
+ * 			compares the two tap sets, their magnitude responses at N_FREQ
+ * 			points from DC to FS / 2, and the fast design's gain at its
+ * 			normalising frequency
+ * inputs: - double F_LOW
+ * 		   - double F_HIGH
+ * 		   - double FS
+ * 		   - int WIN_TYPE
+ * 		   - int FILT_TYPE
+ * 		   - int N
+ * 		   - int N_FREQ (>= 2)
+ * 		   - double * ERR (largest difference found, may be NULL)
+ * returns: 0 - within COEF_TOL, 1 - outside it, -1 - failure
+ */
+int filt_verify(double f_low, double f_high, double fs, int win_type,
+		int filt_type, int n, int n_freq, double * err);
+
+#endif /* COEF_HELPER_H_ */
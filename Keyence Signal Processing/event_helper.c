@@ -0,0 +1,502 @@
+/*
+ * event_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: step / edge event detection. Strip edges, splice steps and
+ *      		 height jumps are reported as timestamped events per channel,
+ *      		 so consumers need not rescan the filtered stream.
+ *
+ *      		 Detectors:
+ *      		   EV_DERIV  x[n] - x[n - SPAN] crossing THRESH fires an event;
+ *      		             the channel re-arms once the difference falls back
+ *      		             under HYST (hysteresis, HYST < THRESH). The edge
+ *      		             lies within the SPAN samples before the event.
+ *      		   EV_CUSUM  two sided CUSUM against a baseline (EWMA over SPAN
+ *      		             samples, frozen while a change accumulates). Fires
+ *      		             when the sum passes THRESH, HYST is the drift
+ *      		             allowance. The baseline restarts at the new level.
+ *
+ *      		 The index builder runs a detector over a text capture (one
+ *      		 sample per line, as written by the pipeline "sink file") with
+ *      		 several threads, each on a slice of the file, and writes the
+ *      		 events with the byte offset of their line so tools can seek
+ *      		 to them directly. Each thread first runs WARM samples before its
+ *      		 slice to settle the detector state.
+ *
+ *      		 Index file: "KEVI", int32 { EV_VERSION, OUT_NUM }, double fs,
+ *      		 int64 n_events, then n_events ev_event records.
+ */
+
+#include "event_helper.h"
+
+/*
+ * function: ev_reset
+ * purpose: restarts detection and the sample count, keeping the settings
+ * inputs: - ev_det * ED
+ * returns: 0 - success, -1 - failure
+ */
+int ev_reset(ev_det * ed) {
+	if (ed == NULL )
+		return -1;
+	ed->n = 0;
+	ed->pos = 0;
+	if (ed->hist != NULL )
+		memset(ed->hist, 0, sizeof(sig_type) * ed->span);
+	int j;
+	for (j = 0; j < OUT_NUM; j++) {
+		ed->armed[j] = 1;
+		ed->started[j] = 0;
+		ed->mean[j] = 0.0;
+		ed->g_pos[j] = 0.0;
+		ed->g_neg[j] = 0.0;
+	}
+	return 0;
+} /* int ev_reset */
+
+/*
+ * function: ev_init
+ * purpose: sets up a step / edge detector for all channels
+ * inputs: - ev_det * ED
+ * 		   - int MODE (EV_DERIV, EV_CUSUM)
+ * 		   - double FS (for event times)
+ * 		   - double THRESH (EV_DERIV: difference, EV_CUSUM: decision level)
+ * 		   - double HYST (EV_DERIV: re-arm level, EV_CUSUM: drift allowance)
+ * 		   - int SPAN (EV_DERIV: difference lag, EV_CUSUM: baseline length)
+ * returns: 0 - success, -1 - failure
+ */
+int ev_init(ev_det * ed, int mode, double fs, double thresh, double hyst,
+		int span) {
+	if (ed == NULL || (mode != EV_DERIV && mode != EV_CUSUM) || fs <= 0.0
+			|| thresh <= 0.0 || hyst < 0.0 || span < 1
+			|| (mode == EV_DERIV && hyst >= thresh)) {
+		printf("Error: ev_init invalid parameters!\n");
+		return -1;
+	}
+	memset(ed, 0, sizeof(ev_det));
+	ed->mode = mode;
+	ed->fs = fs;
+	ed->thresh = thresh;
+	ed->hyst = hyst;
+	ed->span = span;
+	ed->alpha = 1.0 / span;
+	if (mode == EV_DERIV) {
+		ed->hist = (double *) malloc(sizeof(sig_type) * span);
+		if (ed->hist == NULL ) {
+			printf("Error: ev_init failed mem allocation!\n");
+			return -1;
+		}
+	}
+	return ev_reset(ed);
+} /* int ev_init */
+
+/*
+ * function: ev_free
+ * purpose: releases memory held by an ev_det
+ * inputs: - ev_det * ED
+ * returns: 0 - success, -1 - failure
+ */
+int ev_free(ev_det * ed) {
+	if (ed == NULL )
+		return -1;
+	free(ed->hist);
+	memset(ed, 0, sizeof(ev_det));
+	return 0;
+} /* int ev_free */
+
+static void ev_emit(ev_det * ed, ev_event * ev, int j, double mag) {
+	ev->index = ed->n;
+	ev->offset = -1;
+	ev->time = ed->n / ed->fs;
+	ev->mag = mag;
+	ev->ch = j;
+	ev->dir = (mag > 0.0) ? 1 : -1;
+}
+
+/*
+ * function: ev_process
+ * purpose: feeds one sample per channel and writes any events it completes.
+ * 			NAN samples are skipped but still count towards the sample index.
+ * inputs: - ev_det * ED
+ * 		   - sig_type INPUT
+ * 		   - ev_event * EV (room for OUT_NUM events)
+ * returns: number of events written, -1 - failure
+ */
+int ev_process(ev_det * ed, sig_type input, ev_event * ev) {
+	if (ed == NULL || ed->mode == EV_OFF || ev == NULL )
+		return -1;
+
+	int n_ev = 0;
+	int j;
+	if (ed->mode == EV_DERIV) {
+		double * old = ed->hist + ed->pos * OUT_NUM;
+		for (j = 0; j < OUT_NUM; j++) {
+			double x = input[j];
+			if (isnan(x))
+				continue;
+			// no difference until SPAN samples are in
+			double d = (ed->n >= ed->span) ? x - old[j] : 0.0;
+			old[j] = x;
+			if (ed->armed[j] && fabs(d) >= ed->thresh) {
+				ev_emit(ed, &ev[n_ev++], j, d);
+				ed->armed[j] = 0;
+			} else if (!ed->armed[j] && fabs(d) <= ed->hyst) {
+				ed->armed[j] = 1;
+			}
+		}
+		ed->pos = (ed->pos + 1 == ed->span) ? 0 : ed->pos + 1;
+	} else {
+		for (j = 0; j < OUT_NUM; j++) {
+			double x = input[j];
+			if (isnan(x))
+				continue;
+			if (!ed->started[j]) {
+				ed->mean[j] = x;
+				ed->started[j] = 1;
+			}
+			double e = x - ed->mean[j];
+			double gp = ed->g_pos[j] + e - ed->hyst;
+			double gn = ed->g_neg[j] - e - ed->hyst;
+			gp = (gp > 0.0) ? gp : 0.0;
+			gn = (gn > 0.0) ? gn : 0.0;
+			if (gp > ed->thresh || gn > ed->thresh) {
+				ev_emit(ed, &ev[n_ev++], j, e);
+				ed->mean[j] = x;
+				gp = 0.0;
+				gn = 0.0;
+			} else if (gp == 0.0 && gn == 0.0) {
+				ed->mean[j] += ed->alpha * e;
+			}
+			ed->g_pos[j] = gp;
+			ed->g_neg[j] = gn;
+		}
+	}
+	ed->n++;
+	return n_ev;
+} /* int ev_process */
+
+/*
+ * function: ev_block
+ * purpose: feeds LEN samples, keeping the first MAX_EV events
+ * inputs: - ev_det * ED
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * 		   - ev_event * EV
+ * 		   - int MAX_EV
+ * returns: number of events written, -1 - failure
+ */
+int ev_block(ev_det * ed, sig_type * in, int len, ev_event * ev, int max_ev) {
+	if (ed == NULL || in == NULL || ev == NULL )
+		return -1;
+	ev_event tmp[OUT_NUM];
+	int n_ev = 0;
+	int i, k;
+	for (i = 0; i < len; i++) {
+		int r = ev_process(ed, in[i], tmp);
+		if (r == -1)
+			return -1;
+		for (k = 0; k < r && n_ev < max_ev; k++)
+			ev[n_ev++] = tmp[k];
+	}
+	return n_ev;
+} /* int ev_block */
+
+// one slice of a capture for the index builder
+typedef struct {
+	char * path;
+	ev_det * proto;
+	int64_t b0;
+	int64_t b1;
+	int64_t warm_bytes;
+	int64_t first_index;
+	int64_t n_lines;
+	ev_event * ev;
+	int64_t n_ev;
+	int64_t cap;
+	int err;
+} ev_slice;
+
+// offset of the first line starting at or after POS
+static int64_t ev_line_start(FILE * fp, int64_t pos) {
+	if (pos <= 0)
+		return 0;
+	if (fseeko(fp, pos - 1, SEEK_SET) != 0)
+		return -1;
+	int c;
+	while ((c = fgetc(fp)) != EOF && c != '\n')
+		pos++;
+	return pos;
+}
+
+// counts the lines of a slice
+static void * ev_count_lines(void * arg) {
+	ev_slice * sl = (ev_slice *) arg;
+	FILE * fp = fopen(sl->path, "rb");
+	char buf[1 << 16];
+	if (fp == NULL || fseeko(fp, sl->b0, SEEK_SET) != 0) {
+		sl->err = -1;
+		if (fp != NULL )
+			fclose(fp);
+		return NULL ;
+	}
+	int64_t left = sl->b1 - sl->b0;
+	char last = '\n';
+	while (left > 0) {
+		size_t want = (left < (int64_t) sizeof(buf)) ? (size_t) left : sizeof(buf);
+		size_t got = fread(buf, 1, want, fp);
+		if (got == 0) {
+			sl->err = -1;
+			break;
+		}
+		size_t i;
+		for (i = 0; i < got; i++)
+			sl->n_lines += (buf[i] == '\n');
+		last = buf[got - 1];
+		left -= got;
+	}
+	// an unterminated last line
+	if (sl->b1 > sl->b0 && last != '\n')
+		sl->n_lines++;
+	fclose(fp);
+	return NULL ;
+}
+
+// runs a private copy of the detector over a slice and its warm up
+static void * ev_scan_slice(void * arg) {
+	ev_slice * sl = (ev_slice *) arg;
+	ev_det ed;
+	ev_event tmp[OUT_NUM];
+	// whole lines, one sample per line as ev_count_lines counts them
+	char * line = NULL;
+	size_t line_cap = 0;
+	FILE * fp = fopen(sl->path, "rb");
+	if (fp == NULL
+			|| ev_init(&ed, sl->proto->mode, sl->proto->fs, sl->proto->thresh,
+					sl->proto->hyst, sl->proto->span) == -1) {
+		sl->err = -1;
+		if (fp != NULL )
+			fclose(fp);
+		return NULL ;
+	}
+
+	int64_t off = ev_line_start(fp, sl->b0 - sl->warm_bytes);
+	int64_t base = -1;
+	ssize_t len;
+	if (off < 0 || fseeko(fp, off, SEEK_SET) != 0)
+		sl->err = -1;
+	while (sl->err == 0 && off < sl->b1 && (len = getline(&line, &line_cap, fp)) != -1) {
+		sig_type x;
+		char * p = line;
+		char * q;
+		int j;
+		for (j = 0; j < OUT_NUM; j++) {
+			x[j] = strtod(p, &q);
+			if (q == p)
+				x[j] = NAN;
+			p = q;
+		}
+		// local sample count where the slice proper begins
+		if (base < 0 && off >= sl->b0)
+			base = ed.n;
+		int r = ev_process(&ed, x, tmp);
+		int k;
+		for (k = 0; k < r && base >= 0; k++) {
+			if (sl->n_ev == sl->cap) {
+				int64_t cap = (sl->cap == 0) ? 1024 : 2 * sl->cap;
+				ev_event * ev = (ev_event *) realloc(sl->ev, sizeof(ev_event) * cap);
+				if (ev == NULL ) {
+					sl->err = -1;
+					break;
+				}
+				sl->ev = ev;
+				sl->cap = cap;
+			}
+			ev_event * e = &sl->ev[sl->n_ev++];
+			*e = tmp[k];
+			e->index = sl->first_index + (tmp[k].index - base);
+			e->offset = off;
+			e->time = e->index / ed.fs;
+		}
+		off += len;
+	}
+	free(line);
+	ev_free(&ed);
+	fclose(fp);
+	return NULL ;
+}
+
+/*
+ * function: ev_index_build
+ * purpose: detects events in a text capture with N_THREADS threads and writes
+ * 			them, in sample order, to an index file. PROTO supplies the
+ * 			detector settings and is not modified.
+ * inputs: - char * CAPTURE
+ * 		   - char * INDEX_PATH
+ * 		   - ev_det * PROTO
+ * 		   - int N_THREADS (1 .. EV_MAX_THREADS)
+ * 		   - int WARM (samples run before each slice to settle the detector)
+ * returns: number of events, -1 - failure
+ */
+int64_t ev_index_build(char * capture, char * index_path, ev_det * proto,
+		int n_threads, int warm) {
+	if (capture == NULL || index_path == NULL || proto == NULL
+			|| proto->mode == EV_OFF || n_threads < 1
+			|| n_threads > EV_MAX_THREADS || warm < 0) {
+		printf("Error: ev_index_build invalid parameters!\n");
+		return -1;
+	}
+	FILE * fp = fopen(capture, "rb");
+	if (fp == NULL ) {
+		printf("Error: ev_index_build could not open %s!\n", capture);
+		return -1;
+	}
+	fseeko(fp, 0, SEEK_END);
+	int64_t size = ftello(fp);
+
+	// slices start on line boundaries
+	ev_slice sl[EV_MAX_THREADS];
+	pthread_t th[EV_MAX_THREADS];
+	memset(sl, 0, sizeof(sl));
+	int t;
+	int n_run;
+	int err = 0;
+	for (t = 0; t < n_threads; t++) {
+		sl[t].path = capture;
+		sl[t].proto = proto;
+		sl[t].b0 = (t == 0) ? 0 : ev_line_start(fp, size * t / n_threads);
+		if (sl[t].b0 < 0)
+			err = -1;
+		if (t > 0)
+			sl[t - 1].b1 = sl[t].b0;
+	}
+	sl[n_threads - 1].b1 = size;
+	fclose(fp);
+
+	// first pass: lines per slice give each slice its first sample index
+	int64_t n_lines = 0;
+	// only the threads that started are joined
+	for (n_run = 0; n_run < n_threads && err == 0; n_run++)
+		if (pthread_create(&th[n_run], NULL, ev_count_lines, &sl[n_run]) != 0) {
+			err = -1;
+			break;
+		}
+	for (t = 0; t < n_run; t++)
+		pthread_join(th[t], NULL );
+	for (t = 0; t < n_threads && err == 0; t++) {
+		sl[t].first_index = n_lines;
+		n_lines += sl[t].n_lines;
+		err = sl[t].err;
+	}
+
+	// second pass: detection, warm up sized from the mean line length
+	int64_t warm_bytes = (n_lines > 0) ? (int64_t) warm * (size / n_lines + 1) : 0;
+	for (n_run = 0; n_run < n_threads && err == 0; n_run++) {
+		sl[n_run].warm_bytes = warm_bytes;
+		if (pthread_create(&th[n_run], NULL, ev_scan_slice, &sl[n_run]) != 0) {
+			err = -1;
+			break;
+		}
+	}
+	for (t = 0; t < n_run; t++)
+		pthread_join(th[t], NULL );
+
+	int64_t n_ev = 0;
+	for (t = 0; t < n_threads; t++) {
+		if (sl[t].err == -1)
+			err = -1;
+		n_ev += sl[t].n_ev;
+	}
+	if (err == -1) {
+		printf("Error: ev_index_build failed scanning %s!\n", capture);
+	} else if ((fp = fopen(index_path, "wb")) == NULL ) {
+		printf("Error: ev_index_build could not open %s!\n", index_path);
+		err = -1;
+	} else {
+		int32_t hdr[2] = { EV_VERSION, OUT_NUM };
+		if (fwrite("KEVI", 1, 4, fp) != 4 || fwrite(hdr, sizeof(hdr), 1, fp) != 1
+				|| fwrite(&proto->fs, sizeof(double), 1, fp) != 1
+				|| fwrite(&n_ev, sizeof(int64_t), 1, fp) != 1)
+			err = -1;
+		for (t = 0; t < n_threads && err == 0; t++)
+			if (sl[t].n_ev > 0
+					&& fwrite(sl[t].ev, sizeof(ev_event), sl[t].n_ev, fp)
+							!= (size_t) sl[t].n_ev)
+				err = -1;
+		if (fclose(fp) != 0)
+			err = -1;
+		if (err == -1)
+			printf("Error: ev_index_build failed writing %s!\n", index_path);
+	}
+	for (t = 0; t < n_threads; t++)
+		free(sl[t].ev);
+	return (err == -1) ? -1 : n_ev;
+} /* int64_t ev_index_build */
+
+/*
+ * function: ev_index_load
+ * purpose: reads an index file written by ev_index_build. The caller frees
+ * 			*EVENTS.
+ * inputs: - char * PATH
+ * 		   - ev_event ** EVENTS
+ * 		   - int64_t * N_EV
+ * 		   - double * FS (may be NULL)
+ * returns: 0 - success, -1 - failure
+ */
+int ev_index_load(char * path, ev_event ** events, int64_t * n_ev, double * fs) {
+	if (path == NULL || events == NULL || n_ev == NULL )
+		return -1;
+	FILE * fp = fopen(path, "rb");
+	if (fp == NULL ) {
+		printf("Error: ev_index_load could not open %s!\n", path);
+		return -1;
+	}
+	char magic[4];
+	int32_t hdr[2];
+	double rate;
+	int64_t n;
+	ev_event * ev = NULL;
+	int err = 0;
+	if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, "KEVI", 4) != 0
+			|| fread(hdr, sizeof(hdr), 1, fp) != 1 || hdr[0] != EV_VERSION
+			|| hdr[1] != OUT_NUM || fread(&rate, sizeof(double), 1, fp) != 1
+			|| fread(&n, sizeof(int64_t), 1, fp) != 1 || n < 0) {
+		printf("Error: ev_index_load %s is not an event index!\n", path);
+		err = -1;
+	} else if (n > 0
+			&& ((ev = (ev_event *) malloc(sizeof(ev_event) * n)) == NULL
+					|| fread(ev, sizeof(ev_event), n, fp) != (size_t) n)) {
+		printf("Error: ev_index_load failed reading %s!\n", path);
+		free(ev);
+		ev = NULL;
+		err = -1;
+	}
+	fclose(fp);
+	if (err == -1)
+		return -1;
+	*events = ev;
+	*n_ev = n;
+	if (fs != NULL )
+		*fs = rate;
+	return 0;
+} /* int ev_index_load */
+
+/*
+ * function: ev_index_find
+ * purpose: binary search of a loaded index for the first event at or after
+ * 			TIME seconds
+ * inputs: - ev_event * EVENTS
+ * 		   - int64_t N_EV
+ * 		   - double TIME
+ * returns: position in EVENTS, N_EV if every event is earlier
+ */
+int64_t ev_index_find(ev_event * events, int64_t n_ev, double time) {
+	int64_t lo = 0, hi = n_ev;
+	while (lo < hi) {
+		int64_t mid = lo + (hi - lo) / 2;
+		if (events[mid].time < time)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+} /* int64_t ev_index_find */
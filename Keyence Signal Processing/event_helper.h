@@ -0,0 +1,139 @@
+/*
+ * event_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef EVENT_HELPER_H_
+#define EVENT_HELPER_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include "sig_support.c"
+
+#define EV_VERSION 1
+#define EV_MAX_THREADS 64
+
+// detector modes, EV_OFF (a zeroed ev_det) detects nothing
+#define EV_OFF 0
+#define EV_DERIV 1
+#define EV_CUSUM 2
+
+typedef struct {
+	int64_t index;
+	// byte offset of the sample's line in a capture, -1 for live streams
+	int64_t offset;
+	double time;
+	// signed step size
+	double mag;
+	int32_t ch;
+	int32_t dir;
+} ev_event;
+
+typedef struct {
+	int mode;
+	double fs;
+	double thresh;
+	double hyst;
+	int span;
+	int64_t n;
+	// EV_DERIV: last SPAN samples
+	double * hist;
+	int pos;
+	int armed[OUT_NUM];
+	// EV_CUSUM
+	double alpha;
+	int started[OUT_NUM];
+	double mean[OUT_NUM];
+	double g_pos[OUT_NUM];
+	double g_neg[OUT_NUM];
+} ev_det;
+
+/*
+ * function: ev_reset
+ * purpose: restarts detection and the sample count, keeping the settings
+ * inputs: - ev_det * ED
+ * returns: 0 - success, -1 - failure
+ */
+int ev_reset(ev_det * ed);
+
+/*
+ * function: ev_init
+ * purpose: sets up a derivative (EV_DERIV) or CUSUM (EV_CUSUM) step detector
+ * inputs: - ev_det * ED
+ * 		   - int MODE
+ * 		   - double FS
+ * 		   - double THRESH
+ * 		   - double HYST
+ * 		   - int SPAN
+ * returns: 0 - success, -1 - failure
+ */
+int ev_init(ev_det * ed, int mode, double fs, double thresh, double hyst,
+		int span);
+
+/*
+ * function: ev_free
+ * purpose: releases memory held by an ev_det
+ * inputs: - ev_det * ED
+ * returns: 0 - success, -1 - failure
+ */
+int ev_free(ev_det * ed);
+
+/*
+ * function: ev_process
+ * purpose: feeds one sample per channel, writes up to OUT_NUM events
+ * inputs: - ev_det * ED
+ * 		   - sig_type INPUT
+ * 		   - ev_event * EV
+ * returns: number of events written, -1 - failure
+ */
+int ev_process(ev_det * ed, sig_type input, ev_event * ev);
+
+/*
+ * function: ev_block
+ * purpose: feeds LEN samples, keeping the first MAX_EV events
+ * inputs: - ev_det * ED
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * 		   - ev_event * EV
+ * 		   - int MAX_EV
+ * returns: number of events written, -1 - failure
+ */
+int ev_block(ev_det * ed, sig_type * in, int len, ev_event * ev, int max_ev);
+
+/*
+ * function: ev_index_build
+ * purpose: detects events in a text capture in parallel and writes an index
+ * 			file of them, with the byte offset of each event's line
+ * inputs: - char * CAPTURE
+ * 		   - char * INDEX_PATH
+ * 		   - ev_det * PROTO (detector settings)
+ * 		   - int N_THREADS
+ * 		   - int WARM
+ * returns: number of events, -1 - failure
+ */
+int64_t ev_index_build(char * capture, char * index_path, ev_det * proto,
+		int n_threads, int warm);
+
+/*
+ * function: ev_index_load
+ * purpose: reads an index file written by ev_index_build
+ * inputs: - char * PATH
+ * 		   - ev_event ** EVENTS
+ * 		   - int64_t * N_EV
+ * 		   - double * FS (may be NULL)
+ * returns: 0 - success, -1 - failure
+ */
+int ev_index_load(char * path, ev_event ** events, int64_t * n_ev, double * fs);
+
+/*
+ * function: ev_index_find
+ * purpose: first event at or after TIME seconds in a loaded index
+ * inputs: - ev_event * EVENTS
+ * 		   - int64_t N_EV
+ * 		   - double TIME
+ * returns: position in EVENTS, N_EV if every event is earlier
+ */
+int64_t ev_index_find(ev_event * events, int64_t n_ev, double time);
+
+#endif /* EVENT_HELPER_H_ */
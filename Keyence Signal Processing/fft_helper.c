@@ -6,12 +6,16 @@
  * Organization: N12 Technologies
  */
 
-#include "sig_support.c"
+#include "fft_helper.h"
+#include "minmax_helper.h"
+#include "plan_helper.h"
 
 /*
  * function: fft_init
  * purpose: fftw3 initialization functions, allocates arrays of type double and fftw_complex
- * 			of width: OUT_NUM and length: FFT_BUFFER or FFT_HALFBUFF
+ * 			of width: OUT_NUM and length: FFT_BUFFER or FFT_HALFBUFF.
+ * 			FFT_BUFFER may be any length >= 2; every channel shares one cached
+ * 			plan (plan_get), executed on its own arrays by detect_amplitude.
  * inputs: - double * IN[]
  * 		   - fftw_complex * OUT[]
  * 		   - fftw_plan plan[]
@@ -25,7 +29,8 @@ int fft_init(double * in[], fftw_complex * out[], fftw_plan p[], int fft_buffer)
 	int i;
 	for (i = 0; i < OUT_NUM; i++) {
 		// Allocate memory for the input and output buffers
-		*(in + i) = (double *) malloc(sizeof(double) * fft_buffer);
+		// fftw_malloc, so the alignment matches the cached plan
+		*(in + i) = (double *) fftw_malloc(sizeof(double) * fft_buffer);
 		*(out + i) = (fftw_complex *) fftw_malloc(
 				sizeof(fftw_complex) * FFT_HALFBUFF);
 
@@ -35,11 +40,11 @@ int fft_init(double * in[], fftw_complex * out[], fftw_plan p[], int fft_buffer)
 		}
 
 		// initialize buffers to 0
-		memset(in[i], 0, fft_buffer);
-		memset(out[i], 0, FFT_HALFBUFF);
+		memset(in[i], 0, sizeof(double) * fft_buffer);
+		memset(out[i], 0, sizeof(fftw_complex) * FFT_HALFBUFF);
 
-		// generate plan for FFTW 3, exhaustive mode.
-		p[i] = fftw_plan_dft_r2c_1d(fft_buffer, in[i], out[i], FFTW_EXHAUSTIVE);
+		// planned on the first channel, a cache hit for the others
+		p[i] = plan_get(fft_buffer, PLAN_R2C, 1, 1);
 		if (p[i] == NULL ) {
 			printf("ERROR: fft_init failed to generate %d plans for fftw!\n",
 					(OUT_NUM - i));
@@ -51,14 +56,14 @@ int fft_init(double * in[], fftw_complex * out[], fftw_plan p[], int fft_buffer)
 
 /*
  * function: power_buff
- * purpose: allocates memory for the power spectrum buffer of type sig_type.
- * inputs: - sig_type * PB
+ * purpose: allocates zeroed memory for the power spectrum buffer of type sig_type.
+ * inputs: - sig_type ** PB
  * 		   - int FFT_HALFBUFF
  * returns: 0 - success, -1 - failure
  */
-int PB_alloc(sig_type * pb, int FFT_HALFBUFF) {
-	pb = (sig_type *) malloc(sizeof(sig_type) * FFT_HALFBUFF);
-	int err = (pb != NULL ) ? 0 : -1;
+int PB_alloc(sig_type ** pb, int FFT_HALFBUFF) {
+	*pb = (sig_type *) calloc(FFT_HALFBUFF, sizeof(sig_type));
+	int err = (*pb != NULL ) ? 0 : -1;
 	return err;
 }
 
@@ -68,25 +73,26 @@ int PB_alloc(sig_type * pb, int FFT_HALFBUFF) {
  * 			Applies a FFT algorithm first to deduce the real and img amplitude
  * 			components of the signal.
  * inputs: - fftw_plan p[]
+ * 		   - double * IN[]
  * 		   - fftw_complex * OUT[]
  * 		   - sig_type * PB
  * 		   - int FFT_HALFBUFF
  * returns: 0 - success, -1 - failure
  */
-int detect_amplitude(fftw_plan p[], fftw_complex * out[], sig_type * pb, int fft_halfbuff) {
+int detect_amplitude(fftw_plan p[], double * in[], fftw_complex * out[], sig_type * pb, int fft_halfbuff) {
 	int k;
 	for (k = 0; k < OUT_NUM; k++) {
-		fftw_execute(p[k]);
+		fftw_execute_dft_r2c(p[k], in[k], out[k]);
 	}
 
 	int i = 0;
 	int j = 0;
 	for (i = 0; i < fft_halfbuff; i++) {
 		for (j = 0; j < OUT_NUM; j++) {
-			double re = *(out[j] + i)[0];
-			double im = *(out[j] + i)[1];
+			double re = out[j][i][0];
+			double im = out[j][i][1];
 
-			*(pb + i)[j] = sqrt((re * re) + (im * im));
+			pb[i][j] = sqrt((re * re) + (im * im));
 		}
 	}
 	if (i != (fft_halfbuff - 1) && j != (OUT_NUM - 1))
@@ -96,39 +102,18 @@ int detect_amplitude(fftw_plan p[], fftw_complex * out[], sig_type * pb, int fft
 }
 
 /*
- * Min/Max functions for radix 2 arrays
- * (WORK IN PROGRESS)
+ * function: PB_minmax
+ * purpose: per channel min and max of the power spectrum and the bins they
+ * 			occur in (first bin on ties)
+ * inputs: - sig_type * PB
+ * 		   - int FFT_HALFBUFF
+ * 		   - sig_type MIN
+ * 		   - sig_type MAX
+ * 		   - int * IMIN (OUT_NUM values, may be NULL)
+ * 		   - int * IMAX (OUT_NUM values, may be NULL)
+ * returns: 0 - success, -1 - failure
  */
-double * Max(double *array, int n) {
-	if (n % 2 != 0) {
-		return array;
-	} else {
-		double array2[n / 2];
-		int k = 0;
-		int imax;
-		for (imax = 0; imax < n / 2; imax += 2) {
-			array2[k] =
-					(array[imax] >= array[imax + 1]) ?
-							array[imax] : array[imax + 1];
-			k++;
-		}
-		return Max(array2, n / 2);
-	}
-}
-
-double * Min(double *array, int n) {
-	if (n % 2 != 0) {
-		return array;
-	} else {
-		double array2[n / 2];
-		int k;
-		int imin;
-		for (imin = 0; imin < n / 2; imin += 2) {
-			array2[k] =
-					(array[imin] <= array[imin + 1]) ?
-							array[imin] : array[imin + 1];
-			k++;
-		}
-		return Min(array2, n / 2);
-	}
+int PB_minmax(sig_type * pb, int fft_halfbuff, sig_type min, sig_type max,
+		int * imin, int * imax) {
+	return mm_reduce_sig(pb, fft_halfbuff, min, max, imin, imax);
 }
@@ -8,7 +8,7 @@
 #ifndef FFT_HELPER_H_
 #define FFT_HELPER_H_
 
-#include "fft_helper.c"
+#include "sig_support.c"
 
 /*
  * function: fft_init
@@ -24,12 +24,12 @@ int fft_init(double * in[], fftw_complex * out[], fftw_plan p[], int fft_buffer)
 
 /*
  * function: power_buff
- * purpose: allocates memory for the power spectrum buffer of type sig_type.
- * inputs: - sig_type * PB
+ * purpose: allocates zeroed memory for the power spectrum buffer of type sig_type.
+ * inputs: - sig_type ** PB
  * 		   - int FFT_HALFBUFF
  * returns: 0 - success, -1 - failure
  */
-int PB_alloc(sig_type * pb, int FFT_HALFBUFF);
+int PB_alloc(sig_type ** pb, int FFT_HALFBUFF);
 
 /*
  * function: detect_amplitude
@@ -37,13 +37,26 @@ int PB_alloc(sig_type * pb, int FFT_HALFBUFF);
  * 			Applies a FFT algorithm first to deduce the real and img amplitude
  * 			components of the signal.
  * inputs: - fftw_plan p[]
+ * 		   - double * IN[]
  * 		   - fftw_complex * OUT[]
  * 		   - sig_type * PB
  * 		   - int FFT_HALFBUFF
  * returns: 0 - success, -1 - failure
  */
-int detect_amplitude(fftw_plan p[], fftw_complex * out[], sig_type * pb, int fft_halfbuff);
-
+int detect_amplitude(fftw_plan p[], double * in[], fftw_complex * out[], sig_type * pb, int fft_halfbuff);
 
+/*
+ * function: PB_minmax
+ * purpose: per channel min and max of the power spectrum and their bins
+ * inputs: - sig_type * PB
+ * 		   - int FFT_HALFBUFF
+ * 		   - sig_type MIN
+ * 		   - sig_type MAX
+ * 		   - int * IMIN
+ * 		   - int * IMAX
+ * returns: 0 - success, -1 - failure
+ */
+int PB_minmax(sig_type * pb, int fft_halfbuff, sig_type min, sig_type max,
+		int * imin, int * imax);
 
 #endif /* FFT_HELPER_H_ */
@@ -12,21 +12,41 @@
 #define FFT_SUPPORT_H_
 
 #include "support.h"
+#include "minmax_helper.h"
+#include "plan_helper.h"
+
+/*
+ * function: fft_set_len
+ * purpose: sets the FFT length used by fft_init, PB_alloc and detect_amplitude.
+ * 			Any length >= 2 works, not only powers of two. Call before init_all.
+ * returns: 0 - success, -1 - failure
+ */
+static inline int fft_set_len(int len) {
+	if (len < 2) {
+		printf("Error: fft_set_len invalid length %d!\n", len);
+		return -1;
+	}
+	fft_len = len;
+	fft_halfbuff = (len / 2) + 1;
+	return 0;
+}
 
 /*
  * function: fft_init
  * purpose: fftw3 initialization functions, allocates arrays of type double and fftw_complex
- * 			of width: OUT_NUM and length: FFT_BUFFER or FFT_HALFBUFF
+ * 			of width: OUT_NUM and length: fft_len or fft_halfbuff
+ * 			every channel shares one cached plan (plan_get), executed on its own arrays
  * returns: 0 - success, -1 - failure
  */
-int fft_init() {
+static inline int fft_init() {
 	// iterate through OUT_NUM
 	int i;
 	for (i = 0; i < OUT_NUM; i++) {
 		// Allocate memory for the input and output buffers
-		IN[i] = (double *) malloc(sizeof(double) * FFT_BUFFER);
+		// fftw_malloc, so the alignment matches the cached plan
+		IN[i] = (double *) fftw_malloc(sizeof(double) * fft_len);
 		OUT[i] = (fftw_complex *) fftw_malloc(
-				sizeof(fftw_complex) * FFT_HALFBUFF);
+				sizeof(fftw_complex) * fft_halfbuff);
 
 		if (IN[i] == NULL || OUT[i] == NULL ) {
 			printf("Error: fft_init failed mem allocation on %d array!\n", i);
@@ -34,11 +54,11 @@ int fft_init() {
 		}
 
 		// initialize buffers to 0
-		memset(IN[i], 0, FFT_BUFFER);
-		memset(OUT[i], 0, FFT_HALFBUFF);
+		memset(IN[i], 0, sizeof(double) * fft_len);
+		memset(OUT[i], 0, sizeof(fftw_complex) * fft_halfbuff);
 
-		// generate plan for FFTW 3, exhaustive mode.
-		p[i] = fftw_plan_dft_r2c_1d(FFT_BUFFER, IN[i], OUT[i], FFTW_EXHAUSTIVE);
+		// planned on the first channel, a cache hit for the others
+		p[i] = plan_get(fft_len, PLAN_R2C, 1, 1);
 		if (p[i] == NULL ) {
 			printf("ERROR: fft_init failed to generate %d plans for fftw!\n",
 					(OUT_NUM - i));
@@ -53,8 +73,8 @@ int fft_init() {
  * purpose: allocates memory for the power spectrum buffer of type sig_type.
  * returns: 0 - success, -1 - failure
  */
-int PB_alloc() {
-	PB = (sig_type *) malloc(sizeof(sig_type) * FFT_HALFBUFF);
+static inline int PB_alloc() {
+	PB = (sig_type *) malloc(sizeof(sig_type) * fft_halfbuff);
 	int err = (PB != NULL ) ? 0 : -1;
 	return err;
 }
@@ -66,64 +86,36 @@ int PB_alloc() {
  * 			components of the signal.
  * returns: 0 - success, -1 - failure
  */
-int detect_amplitude() {
+static inline int detect_amplitude() {
 	int k;
 	for (k = 0; k < OUT_NUM; k++) {
-		fftw_execute(p[k]);
+		fftw_execute_dft_r2c(p[k], IN[k], OUT[k]);
 	}
 
 	int i = 0;
 	int j = 0;
-	for (i = 0; i < FFT_HALFBUFF; i++) {
+	for (i = 0; i < fft_halfbuff; i++) {
 		for (j = 0; j < OUT_NUM; j++) {
-			double re = *(OUT[j] + i)[0];
-			double im = *(OUT[j] + i)[1];
+			double re = OUT[j][i][0];
+			double im = OUT[j][i][1];
 
-			*(PB + i)[j] = sqrt((re * re) + (im * im));
+			PB[i][j] = sqrt((re * re) + (im * im));
 		}
 	}
-	if (i != (FFT_HALFBUFF - 1) && j != (OUT_NUM - 1))
+	if (i != (fft_halfbuff - 1) && j != (OUT_NUM - 1))
 		return -1;
 	else
 		return 0;
 }
 
 /*
- * Min/Max functions for radix 2 arrays
- * (WORK IN PROGRESS)
+ * function: PB_minmax
+ * purpose: per channel min and max of PB and the bins they occur in
+ * 			(first bin on ties)
+ * returns: 0 - success, -1 - failure
  */
-double * Max(double *array, int N) {
-	if (N % 2 != 0) {
-		return array;
-	} else {
-		double array2[N / 2];
-		int k = 0;
-		int imax;
-		for (imax = 0; imax < N / 2; imax += 2) {
-			array2[k] =
-					(array[imax] >= array[imax + 1]) ?
-							array[imax] : array[imax + 1];
-			k++;
-		}
-		return Max(array2, N / 2);
-	}
-}
-
-double * Min(double *array, int N) {
-	if (N % 2 != 0) {
-		return array;
-	} else {
-		double array2[N / 2];
-		int k;
-		int imin;
-		for (imin = 0; imin < N / 2; imin += 2) {
-			array2[k] =
-					(array[imin] <= array[imin + 1]) ?
-							array[imin] : array[imin + 1];
-			k++;
-		}
-		return Min(array2, N / 2);
-	}
+static inline int PB_minmax(sig_type min, sig_type max, int * imin, int * imax) {
+	return mm_reduce_sig(PB, fft_halfbuff, min, max, imin, imax);
 }
 
 #endif /* FFT_SUPPORT */
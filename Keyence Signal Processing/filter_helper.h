@@ -8,30 +8,34 @@
 #ifndef FILTER_HELPER_H_
 #define FILTER_HELPER_H_
 
+#include "sig_support.c"
+#include "coef_helper.h"
+
 /*
  * function: coeff_alloc
- * purpose: Allocates memory for the filter coefficients
- * inputs: - double * W
- * 		   - double * F
+ * purpose: Allocates zeroed memory for the window and the filter coefficients,
+ * 			BUFFER_LEN points each (see filt_coeffs)
+ * inputs: - double ** W
+ * 		   - double ** F
  * 		   - int BUFFER_LEN
  * returns: 0 - success, -1 - failure
  */
-int coeff_alloc(double * w, double * f, int buffer_len);
+int coeff_alloc(double ** w, double ** f, int buffer_len);
 
 /*
  * function: buff_alloc
- * purpose: Allocates memory for the running buffer
- * inputs: - sig_type * FB
+ * purpose: Allocates zeroed memory for the running buffer
+ * inputs: - sig_type ** FB
  * 		   - int BUFFER_LEN
  * returns: 0 - success, -1 - failure
  */
-int FB_alloc(sig_type * fb, int buffer_len);
+int FB_alloc(sig_type ** fb, int buffer_len);
 
 /*
  * function: window_coeffs
- * purpose: calculates window coefficients
+ * purpose: calculates the BUFFER_LEN point symmetric window, as filter_support.h
  * inputs: - int wintype
- *         - double * W
+ *         - double * W (BUFFER_LEN)
  *         - int BUFFER_LEN
  * returns: 0 -success, -1 - failure
  * Codes for int wintype: 0: Hanning, 1: Hamming, 2: Blackman, 3: Blackman-Harris
@@ -40,19 +44,20 @@ int window_coeffs(int wintype, double * w, int buffer_len);
 
 /*
  * function: filt_coeffs
- * purpose: calculates the coefficients for a windowed FIR filter
+ * purpose: calculates BUFFER_LEN coefficients for a windowed FIR filter,
+ * 			normalised to unit passband gain, as filter_support.h
  * inputs: - double F_LOW
  *         - double F_HIGH
  *         - double FS
  *         - int win_type
  *         - int filt_type
- *         - double * W
- *         - double * F
+ *         - double * W (BUFFER_LEN, receives the window, may be NULL)
+ *         - double * F (BUFFER_LEN)
  *         - int BUFFER_LEN
  * returns: 0 - success, -1 - failure
  * codes:
  * 		int win_type: 0: Hanning, 1: Hamming, 2: Blackman, 3: Blackman Harris
- * 		int filt_type: 0: low-pass, 1: high-pass, 2: bandpass
+ * 		int filt_type: 0: low-pass, 1: high-pass (odd BUFFER_LEN), 2: bandpass
  */
 int filt_coeffs(double f_low, double f_high, double fs, int win_type,
 		int filt_type, double * w, double * f, int buffer_len);
@@ -0,0 +1,185 @@
+/*
+ * filtfilt_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: zero phase (forward-backward) FIR filtering of recorded runs.
+ *      		 The record is odd-reflected at both ends, filtered forward, then
+ *      		 filtered again time reversed. Since every output sample only
+ *      		 depends on a 2 * (taps - 1) neighbourhood, the record is cut into
+ *      		 chunks with that much overlap and the chunks are spread over all
+ *      		 cores. Each sample is summed in the same order whichever chunk
+ *      		 computes it, so the result is bit identical to one thread.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "filtfilt_helper.h"
+
+#define FILTFILT_CHUNK 65536
+
+typedef struct {
+	double * taps;
+	int n_taps;
+	sig_type * in;
+	sig_type * out;
+	long len;
+	long padlen;
+	long n_chunks;
+	atomic_long next;
+	atomic_int err;
+} filtfilt_job;
+
+// padded input sample. odd reflection about the end points, zero outside the pad
+static void filtfilt_xp(filtfilt_job * job, long m, double * x) {
+	int j;
+	long i = m - job->padlen;
+	if (m < 0 || m >= job->len + 2 * job->padlen) {
+		for (j = 0; j < OUT_NUM; j++)
+			x[j] = 0.0;
+	} else if (i < 0) {
+		for (j = 0; j < OUT_NUM; j++)
+			x[j] = 2.0 * job->in[0][j] - job->in[-i][j];
+	} else if (i >= job->len) {
+		long r = 2 * (job->len - 1) - i;
+		for (j = 0; j < OUT_NUM; j++)
+			x[j] = 2.0 * job->in[job->len - 1][j] - job->in[r][j];
+	} else {
+		for (j = 0; j < OUT_NUM; j++)
+			x[j] = job->in[i][j];
+	}
+}
+
+// filters output samples [a, b) using the scratch buffers XS and ZS
+static void filtfilt_chunk(filtfilt_job * job, long a, long b, sig_type * xs,
+		sig_type * zs) {
+	int L = job->n_taps;
+	long np = job->len + 2 * job->padlen;
+	long p0 = a + job->padlen;
+	long p1 = b + job->padlen;
+	long m, n;
+	int k, j;
+
+	// padded input over [p0 - L + 1, p1 + L - 1)
+	long x0 = p0 - L + 1;
+	long nx = (p1 - p0) + 2 * (L - 1);
+	for (m = 0; m < nx; m++)
+		filtfilt_xp(job, x0 + m, xs[m]);
+
+	// forward pass z over [p0, p1 + L - 1), zero past the end of the record
+	long nz = (p1 - p0) + (L - 1);
+	for (m = 0; m < nz; m++) {
+		double acc[OUT_NUM] = { 0.0 };
+		if (p0 + m < np) {
+			for (k = 0; k < L; k++)
+				for (j = 0; j < OUT_NUM; j++)
+					acc[j] += job->taps[k] * xs[m + L - 1 - k][j];
+		}
+		for (j = 0; j < OUT_NUM; j++)
+			zs[m][j] = acc[j];
+	}
+
+	// backward pass
+	for (n = 0; n < p1 - p0; n++) {
+		double acc[OUT_NUM] = { 0.0 };
+		for (k = 0; k < L; k++)
+			for (j = 0; j < OUT_NUM; j++)
+				acc[j] += job->taps[k] * zs[n + k][j];
+		for (j = 0; j < OUT_NUM; j++)
+			job->out[a + n][j] = acc[j];
+	}
+}
+
+static void * filtfilt_worker(void * arg) {
+	filtfilt_job * job = (filtfilt_job *) arg;
+	int L = job->n_taps;
+	sig_type * xs = (sig_type *) malloc(
+			sizeof(sig_type) * (FILTFILT_CHUNK + 2 * (L - 1)));
+	sig_type * zs = (sig_type *) malloc(
+			sizeof(sig_type) * (FILTFILT_CHUNK + (L - 1)));
+	if (xs == NULL || zs == NULL ) {
+		atomic_store(&job->err, -1);
+		free(xs);
+		free(zs);
+		return NULL ;
+	}
+
+	long c;
+	while ((c = atomic_fetch_add(&job->next, 1)) < job->n_chunks) {
+		long a = c * FILTFILT_CHUNK;
+		long b = (a + FILTFILT_CHUNK < job->len) ? a + FILTFILT_CHUNK : job->len;
+		filtfilt_chunk(job, a, b, xs, zs);
+	}
+	free(xs);
+	free(zs);
+	return NULL ;
+}
+
+/*
+ * function: filtfilt_fir
+ * purpose: zero phase filtering of a whole record with FIR taps (e.g. from
+ * 			filt_coeffs). The record is padded by odd reflection of
+ * 			3 * (N_TAPS - 1) samples at each end (less for short records).
+ * 			The output is identical for any N_THREADS.
+ * inputs: - double * TAPS
+ * 		   - int N_TAPS
+ * 		   - sig_type * IN
+ * 		   - sig_type * OUT (must not alias IN)
+ * 		   - long LEN
+ * 		   - int N_THREADS (0: one per online core)
+ * returns: 0 - success, -1 - failure
+ */
+int filtfilt_fir(double * taps, int n_taps, sig_type * in, sig_type * out,
+		long len, int n_threads) {
+	if (taps == NULL || n_taps < 1 || in == NULL || out == NULL || len < 2
+			|| in == out) {
+		printf("Error: filtfilt_fir invalid parameters!\n");
+		return -1;
+	}
+
+	filtfilt_job job;
+	job.taps = taps;
+	job.n_taps = n_taps;
+	job.in = in;
+	job.out = out;
+	job.len = len;
+	job.padlen = 3L * (n_taps - 1);
+	if (job.padlen > len - 1)
+		job.padlen = len - 1;
+	job.n_chunks = (len + FILTFILT_CHUNK - 1) / FILTFILT_CHUNK;
+	atomic_init(&job.next, 0);
+	atomic_init(&job.err, 0);
+
+	if (n_threads <= 0)
+		n_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if (n_threads < 1)
+		n_threads = 1;
+	if (n_threads > job.n_chunks)
+		n_threads = (int) job.n_chunks;
+
+	pthread_t * th = (pthread_t *) malloc(sizeof(pthread_t) * n_threads);
+	if (th == NULL ) {
+		printf("Error: filtfilt_fir failed mem allocation!\n");
+		return -1;
+	}
+
+	// the calling thread works too, so n_threads - 1 helpers are started
+	int i;
+	int started = 0;
+	for (i = 1; i < n_threads; i++) {
+		if (pthread_create(&th[i], NULL, filtfilt_worker, &job) != 0)
+			break;
+		started++;
+	}
+	filtfilt_worker(&job);
+	for (i = 1; i <= started; i++)
+		pthread_join(th[i], NULL);
+	free(th);
+
+	if (atomic_load(&job.err) == -1) {
+		printf("Error: filtfilt_fir failed mem allocation!\n");
+		return -1;
+	}
+	return 0;
+} /* int filtfilt_fir */
@@ -0,0 +1,28 @@
+/*
+ * filtfilt_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef FILTFILT_HELPER_H_
+#define FILTFILT_HELPER_H_
+
+#include "sig_support.c"
+
+/*
+ * function: filtfilt_fir
+ * purpose: zero phase filtering of a whole record with FIR taps, split into
+ * 			overlapping chunks over N_THREADS. The output is bit identical for
+ * 			any thread count.
+ * inputs: - double * TAPS
+ * 		   - int N_TAPS
+ * 		   - sig_type * IN
+ * 		   - sig_type * OUT (must not alias IN)
+ * 		   - long LEN
+ * 		   - int N_THREADS (0: one per online core)
+ * returns: 0 - success, -1 - failure
+ */
+int filtfilt_fir(double * taps, int n_taps, sig_type * in, sig_type * out,
+		long len, int n_threads);
+
+#endif /* FILTFILT_HELPER_H_ */
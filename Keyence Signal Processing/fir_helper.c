@@ -0,0 +1,140 @@
+/*
+ * fir_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: self contained FIR state for OUT_NUM channels. Unlike filter_process
+ *      		 it owns its taps and history, so several filters can run at once.
+ */
+
+#include "fir_helper.h"
+
+/*
+ * function: fir_init
+ * purpose: allocates FIR state and copies the taps
+ * inputs: - fir_filt * FF
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int fir_init(fir_filt * ff, double * taps, int len) {
+	if (ff == NULL || taps == NULL || len < 1) {
+		printf("Error: fir_init invalid parameters!\n");
+		return -1;
+	}
+	memset(ff, 0, sizeof(fir_filt));
+	ff->rtaps = (double *) malloc(sizeof(double) * len);
+	ff->hist = (double *) calloc((size_t) 2 * len * OUT_NUM, sizeof(double));
+	if (ff->rtaps == NULL || ff->hist == NULL ) {
+		free(ff->rtaps);
+		free(ff->hist);
+		printf("Error: fir_init failed mem allocation!\n");
+		return -1;
+	}
+	// reversed so the dot product walks taps and history in the same direction
+	int k;
+	for (k = 0; k < len; k++)
+		ff->rtaps[k] = taps[len - 1 - k];
+	ff->len = len;
+	return 0;
+} /* int fir_init */
+
+/*
+ * function: fir_design
+ * purpose: designs a windowed FIR with fir_taps and initializes FF with it
+ * inputs: - fir_filt * FF
+ * 		   - double F_LOW
+ * 		   - double F_HIGH
+ * 		   - double FS
+ * 		   - int WIN_TYPE
+ * 		   - int FILT_TYPE
+ * 		   - int TAPS (odd)
+ * returns: 0 - success, -1 - failure
+ */
+int fir_design(fir_filt * ff, double f_low, double f_high, double fs,
+		int win_type, int filt_type, int taps) {
+	if (taps < 1 || taps % 2 == 0) {
+		printf("Error: fir_design needs an odd tap count!\n");
+		return -1;
+	}
+
+	double * f = (double *) malloc(sizeof(double) * taps);
+	if (f == NULL ) {
+		printf("Error: fir_design failed mem allocation!\n");
+		return -1;
+	}
+	if (fir_taps(f_low, f_high, fs, win_type, filt_type, f, taps) == -1) {
+		free(f);
+		return -1;
+	}
+
+	int err = fir_init(ff, f, taps);
+	free(f);
+	return err;
+} /* int fir_design */
+
+/*
+ * function: fir_free
+ * purpose: releases memory held by a fir_filt
+ * inputs: - fir_filt * FF
+ * returns: 0 - success, -1 - failure
+ */
+int fir_free(fir_filt * ff) {
+	if (ff == NULL )
+		return -1;
+	free(ff->rtaps);
+	free(ff->hist);
+	ff->rtaps = NULL;
+	ff->hist = NULL;
+	return 0;
+} /* int fir_free */
+
+/*
+ * function: fir_process
+ * purpose: pushes one sample per channel and returns the filtered sample.
+ * 			INPUT and OUTPUT may alias.
+ * inputs: - fir_filt * FF
+ * 		   - sig_type INPUT
+ * 		   - sig_type OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int fir_process(fir_filt * ff, sig_type input, sig_type output) {
+	if (ff == NULL || ff->hist == NULL )
+		return -1;
+
+	int L = ff->len;
+	int j, k;
+	double * h0 = ff->hist + (size_t) ff->pos * OUT_NUM;
+	double * h1 = ff->hist + (size_t) (ff->pos + L) * OUT_NUM;
+	for (j = 0; j < OUT_NUM; j++) {
+		h0[j] = input[j];
+		h1[j] = input[j];
+	}
+	ff->pos = (ff->pos + 1 == L) ? 0 : ff->pos + 1;
+
+	double acc[OUT_NUM] = { 0.0 };
+	double * hist = ff->hist + (size_t) ff->pos * OUT_NUM;
+	for (k = 0; k < L; k++)
+		for (j = 0; j < OUT_NUM; j++)
+			acc[j] += ff->rtaps[k] * hist[k * OUT_NUM + j];
+	for (j = 0; j < OUT_NUM; j++)
+		output[j] = acc[j];
+	return 0;
+} /* int fir_process */
+
+/*
+ * function: fir_block
+ * purpose: runs fir_process over a block of samples. IN and OUT may alias.
+ * inputs: - fir_filt * FF
+ * 		   - sig_type * IN
+ * 		   - sig_type * OUT
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int fir_block(fir_filt * ff, sig_type * in, sig_type * out, int len) {
+	int n;
+	for (n = 0; n < len; n++)
+		if (fir_process(ff, in[n], out[n]) == -1)
+			return -1;
+	return 0;
+} /* int fir_block */
@@ -0,0 +1,78 @@
+/*
+ * fir_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef FIR_HELPER_H_
+#define FIR_HELPER_H_
+
+#include "filter_helper.h"
+
+// FIR state. history is stored twice (ring of LEN written at pos and pos + LEN)
+// so the newest LEN samples are always one contiguous run, channel innermost.
+typedef struct {
+	int len;
+	double * rtaps;
+	double * hist;
+	int pos;
+} fir_filt;
+
+/*
+ * function: fir_init
+ * purpose: allocates FIR state and copies the taps
+ * inputs: - fir_filt * FF
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int fir_init(fir_filt * ff, double * taps, int len);
+
+/*
+ * function: fir_design
+ * purpose: designs a windowed FIR with fir_taps and initializes FF with it
+ * inputs: - fir_filt * FF
+ * 		   - double F_LOW
+ * 		   - double F_HIGH
+ * 		   - double FS
+ * 		   - int WIN_TYPE
+ * 		   - int FILT_TYPE
+ * 		   - int TAPS (odd)
+ * returns: 0 - success, -1 - failure
+ * codes:
+ * 		int win_type: 0: Hanning, 1: Hamming, 2: Blackman, 3: Blackman Harris
+ * 		int filt_type: 0: low-pass, 1: high-pass, 2: bandpass
+ */
+int fir_design(fir_filt * ff, double f_low, double f_high, double fs,
+		int win_type, int filt_type, int taps);
+
+/*
+ * function: fir_free
+ * purpose: releases memory held by a fir_filt
+ * inputs: - fir_filt * FF
+ * returns: 0 - success, -1 - failure
+ */
+int fir_free(fir_filt * ff);
+
+/*
+ * function: fir_process
+ * purpose: pushes one sample per channel and returns the filtered sample
+ * inputs: - fir_filt * FF
+ * 		   - sig_type INPUT
+ * 		   - sig_type OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int fir_process(fir_filt * ff, sig_type input, sig_type output);
+
+/*
+ * function: fir_block
+ * purpose: runs fir_process over a block of samples. IN and OUT may alias.
+ * inputs: - fir_filt * FF
+ * 		   - sig_type * IN
+ * 		   - sig_type * OUT
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int fir_block(fir_filt * ff, sig_type * in, sig_type * out, int len);
+
+#endif /* FIR_HELPER_H_ */
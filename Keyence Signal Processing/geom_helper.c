@@ -0,0 +1,223 @@
+/*
+ * geom_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: cross channel geometry computed from filtered heights. Derived
+ *      		 quantities are affine combinations of the OUT_NUM channels
+ *      		 (thickness = gap - top - bottom, differential = a - b, ...) plus a
+ *      		 least squares plane z = a * x + b * y + c through the heads. All
+ *      		 calibration is folded into one matrix at setup, so each sample
+ *      		 costs a single small matrix-vector product.
+ *
+ *      		 Calibration file lines ('#' starts a comment):
+ *      		   lin <c_0> ... <c_OUT_NUM-1> <offset>
+ *      		   head <channel> <x> <y>
+ */
+
+#include "geom_helper.h"
+
+/*
+ * function: geom_init
+ * purpose: clears a calibration, no outputs until rows or a plane are added
+ * inputs: - geom_cal * GC
+ * returns: 0 - success, -1 - failure
+ */
+int geom_init(geom_cal * gc) {
+	if (gc == NULL )
+		return -1;
+	memset(gc, 0, sizeof(geom_cal));
+	return 0;
+} /* int geom_init */
+
+/*
+ * function: geom_add_lin
+ * purpose: adds an output OFFSET + sum(COEFFS[i] * channel i)
+ * inputs: - geom_cal * GC
+ * 		   - double * COEFFS (OUT_NUM values)
+ * 		   - double OFFSET
+ * returns: 0 - success, -1 - failure
+ */
+int geom_add_lin(geom_cal * gc, double * coeffs, double offset) {
+	if (gc == NULL || coeffs == NULL || gc->n_lin == GEOM_MAX_LIN || gc->plane) {
+		printf("Error: geom_add_lin no room, or plane already fitted!\n");
+		return -1;
+	}
+	memcpy(gc->m[gc->n_lin], coeffs, sizeof(double) * OUT_NUM);
+	gc->off[gc->n_lin] = offset;
+	gc->n_lin++;
+	gc->n_out = gc->n_lin;
+	return 0;
+} /* int geom_add_lin */
+
+/*
+ * function: geom_plane_init
+ * purpose: precomputes the least squares plane fit through heads at XY. For
+ * 			three heads this is the exact plane. The plane adds three outputs
+ * 			after the linear ones: slope along x, slope along y, height at the
+ * 			origin. Tilt angles are atan of the slopes.
+ * inputs: - geom_cal * GC
+ * 		   - double XY[OUT_NUM][2]
+ * returns: 0 - success, -1 - failure
+ */
+int geom_plane_init(geom_cal * gc, double xy[OUT_NUM][2]) {
+	if (gc == NULL || xy == NULL || OUT_NUM < 3)
+		return -1;
+
+	// normal equations about the head centroid, where N = A^T A with rows
+	// of A = [x y 1] splits into the 2 x 2 scatter S and the head count
+	double mx = 0.0, my = 0.0;
+	int i;
+	for (i = 0; i < OUT_NUM; i++) {
+		mx += xy[i][0] / OUT_NUM;
+		my += xy[i][1] / OUT_NUM;
+	}
+	double sxx = 0.0, sxy = 0.0, syy = 0.0;
+	for (i = 0; i < OUT_NUM; i++) {
+		double u = xy[i][0] - mx, v = xy[i][1] - my;
+		sxx += u * u;
+		sxy += u * v;
+		syy += v * v;
+	}
+
+	// det S against (trace S / 2)^2, its bound, so the test holds at any
+	// head spacing and distance from the origin
+	double det = sxx * syy - sxy * sxy;
+	double tr = 0.5 * (sxx + syy);
+	if (!(det > 1e-12 * tr * tr)) {
+		printf("Error: geom_plane_init heads are collinear!\n");
+		return -1;
+	}
+
+	// plane rows = N^-1 A^T, the height moved from the centroid to the origin
+	int base = gc->n_lin;
+	for (i = 0; i < OUT_NUM; i++) {
+		double u = xy[i][0] - mx, v = xy[i][1] - my;
+		double ax = (syy * u - sxy * v) / det;
+		double ay = (sxx * v - sxy * u) / det;
+		gc->m[base][i] = ax;
+		gc->m[base + 1][i] = ay;
+		gc->m[base + 2][i] = 1.0 / OUT_NUM - mx * ax - my * ay;
+	}
+	gc->off[base] = 0.0;
+	gc->off[base + 1] = 0.0;
+	gc->off[base + 2] = 0.0;
+	memmove(gc->head_xy, xy, sizeof(gc->head_xy));
+	gc->plane = 1;
+	gc->n_out = gc->n_lin + 3;
+	return 0;
+} /* int geom_plane_init */
+
+/*
+ * function: geom_load
+ * purpose: builds a calibration from a file of "lin" and "head" lines. GC
+ * 			is only replaced once the whole file has parsed; on failure it
+ * 			keeps its previous calibration.
+ * inputs: - geom_cal * GC
+ * 		   - char * PATH
+ * returns: 0 - success, -1 - failure
+ */
+int geom_load(geom_cal * gc, char * path) {
+	if (gc == NULL || path == NULL )
+		return -1;
+	char line[256];
+	FILE * fp = fopen(path, "r");
+	if (fp == NULL ) {
+		printf("Error: geom_load could not open %s!\n", path);
+		return -1;
+	}
+	geom_cal cal;
+	geom_init(&cal);
+
+	int n_heads = 0;
+	int err = 0;
+	while (err == 0 && fgets(line, sizeof(line), fp) != NULL ) {
+		char name[16];
+		if (sscanf(line, "%15s", name) != 1 || name[0] == '#')
+			continue;
+		if (strcmp(name, "lin") == 0) {
+			double v[OUT_NUM + 1];
+			char * p = line + strspn(line, " \t") + 3;
+			int i, used;
+			for (i = 0; i < OUT_NUM + 1; i++) {
+				if (sscanf(p, "%lf%n", &v[i], &used) != 1)
+					break;
+				p += used;
+			}
+			err = (i == OUT_NUM + 1) ? geom_add_lin(&cal, v, v[OUT_NUM]) : -1;
+		} else if (strcmp(name, "head") == 0) {
+			int ch;
+			double x, y;
+			if (sscanf(line, "%*s %d %lf %lf", &ch, &x, &y) != 3 || ch < 0
+					|| ch >= OUT_NUM) {
+				err = -1;
+			} else {
+				n_heads += !cal.head_set[ch];
+				cal.head_set[ch] = 1;
+				cal.head_xy[ch][0] = x;
+				cal.head_xy[ch][1] = y;
+			}
+		} else {
+			err = -1;
+		}
+		if (err == -1)
+			printf("Error: geom_load could not parse \"%s\"!\n", line);
+	}
+	fclose(fp);
+
+	// the plane goes after every lin row, whatever order the file used
+	if (err == 0 && n_heads == OUT_NUM)
+		err = geom_plane_init(&cal, cal.head_xy);
+	if (err == 0)
+		memcpy(gc, &cal, sizeof(geom_cal));
+	return err;
+} /* int geom_load */
+
+/*
+ * function: geom_process
+ * purpose: derived quantities for one filtered sample
+ * inputs: - geom_cal * GC
+ * 		   - sig_type INPUT
+ * 		   - double * OUTPUT (GC->N_OUT values)
+ * returns: number of outputs written
+ */
+int geom_process(geom_cal * gc, sig_type input, double * output) {
+	int r, j;
+	for (r = 0; r < gc->n_out; r++) {
+		double acc = gc->off[r];
+		for (j = 0; j < OUT_NUM; j++)
+			acc += gc->m[r][j] * input[j];
+		output[r] = acc;
+	}
+	return gc->n_out;
+} /* int geom_process */
+
+/*
+ * function: geom_block
+ * purpose: derived quantities for a block of samples. Output is sample major,
+ * 			GC->N_OUT values per sample. The sample loop is innermost so it
+ * 			vectorises across samples.
+ * inputs: - geom_cal * GC
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * 		   - double * OUT
+ * returns: 0 - success, -1 - failure
+ */
+int geom_block(geom_cal * gc, sig_type * in, int len, double * out) {
+	if (gc == NULL || in == NULL || out == NULL )
+		return -1;
+	int r, j, n;
+	int n_out = gc->n_out;
+	for (r = 0; r < n_out; r++) {
+		double m[OUT_NUM];
+		double off = gc->off[r];
+		memcpy(m, gc->m[r], sizeof(m));
+		for (n = 0; n < len; n++) {
+			double acc = off;
+			for (j = 0; j < OUT_NUM; j++)
+				acc += m[j] * in[n][j];
+			out[(size_t) n * n_out + r] = acc;
+		}
+	}
+	return 0;
+} /* int geom_block */
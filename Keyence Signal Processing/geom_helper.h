@@ -0,0 +1,86 @@
+/*
+ * geom_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef GEOM_HELPER_H_
+#define GEOM_HELPER_H_
+
+#include "sig_support.c"
+
+#define GEOM_MAX_LIN 8
+#define GEOM_MAX_OUT (GEOM_MAX_LIN + 3)
+
+typedef struct {
+	int n_lin;
+	int plane;
+	int n_out;
+	double head_xy[OUT_NUM][2];
+	int head_set[OUT_NUM];
+	// rows 0 .. n_lin - 1: linear outputs, then slope x, slope y, offset
+	double m[GEOM_MAX_OUT][OUT_NUM];
+	double off[GEOM_MAX_OUT];
+} geom_cal;
+
+/*
+ * function: geom_init
+ * purpose: clears a calibration, no outputs until rows or a plane are added
+ * inputs: - geom_cal * GC
+ * returns: 0 - success, -1 - failure
+ */
+int geom_init(geom_cal * gc);
+
+/*
+ * function: geom_add_lin
+ * purpose: adds an output OFFSET + sum(COEFFS[i] * channel i), e.g.
+ * 			thickness {-1, -1, 0} + gap, differential {1, -1, 0} + 0
+ * inputs: - geom_cal * GC
+ * 		   - double * COEFFS
+ * 		   - double OFFSET
+ * returns: 0 - success, -1 - failure
+ */
+int geom_add_lin(geom_cal * gc, double * coeffs, double offset);
+
+/*
+ * function: geom_plane_init
+ * purpose: precomputes the plane fit through heads at XY; adds slope x,
+ * 			slope y and origin height outputs after the linear ones
+ * inputs: - geom_cal * GC
+ * 		   - double XY[OUT_NUM][2]
+ * returns: 0 - success, -1 - failure
+ */
+int geom_plane_init(geom_cal * gc, double xy[OUT_NUM][2]);
+
+/*
+ * function: geom_load
+ * purpose: builds a calibration from a file of "lin" and "head" lines,
+ * 			GC is left unchanged on failure
+ * inputs: - geom_cal * GC
+ * 		   - char * PATH
+ * returns: 0 - success, -1 - failure
+ */
+int geom_load(geom_cal * gc, char * path);
+
+/*
+ * function: geom_process
+ * purpose: derived quantities for one filtered sample
+ * inputs: - geom_cal * GC
+ * 		   - sig_type INPUT
+ * 		   - double * OUTPUT
+ * returns: number of outputs written
+ */
+int geom_process(geom_cal * gc, sig_type input, double * output);
+
+/*
+ * function: geom_block
+ * purpose: derived quantities for a block of samples, GC->N_OUT per sample
+ * inputs: - geom_cal * GC
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * 		   - double * OUT
+ * returns: 0 - success, -1 - failure
+ */
+int geom_block(geom_cal * gc, sig_type * in, int len, double * out);
+
+#endif /* GEOM_HELPER_H_ */
@@ -0,0 +1,369 @@
+/*
+ * median_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: sliding median and Hampel outlier filter. Each channel keeps its
+ *      		 window in a ring buffer and an order statistic treap built over
+ *      		 the ring slots, so insert, delete and rank selection are O(log w).
+ *      		 NAN samples (dropouts) sort last and are left out of the median
+ *      		 and MAD; a NAN centre sample passes through hampel_process.
+ */
+
+#include "median_helper.h"
+
+/*
+ * treap primitives (internal)
+ */
+static int ost_size(ost_node * t, int n) {
+	return (n < 0) ? 0 : t[n].size;
+}
+
+// NAN sorts after every number, so dropouts keep the order total
+static int ost_less(ost_node * t, int a, int b) {
+	double x = t[a].val;
+	double y = t[b].val;
+	if (isnan(x) || isnan(y)) {
+		if (isnan(x) != isnan(y))
+			return isnan(y);
+		return a < b;
+	}
+	if (x != y)
+		return x < y;
+	return a < b;
+}
+
+static void ost_update(ost_node * t, int n) {
+	t[n].size = 1 + ost_size(t, t[n].left) + ost_size(t, t[n].right);
+}
+
+static int ost_merge(ost_node * t, int a, int b) {
+	if (a < 0)
+		return b;
+	if (b < 0)
+		return a;
+	if (t[a].prio > t[b].prio) {
+		t[a].right = ost_merge(t, t[a].right, b);
+		ost_update(t, a);
+		return a;
+	} else {
+		t[b].left = ost_merge(t, a, t[b].left);
+		ost_update(t, b);
+		return b;
+	}
+}
+
+// splits the tree into nodes ordered before n and nodes ordered after n
+static void ost_split(ost_node * t, int root, int n, int * l, int * r) {
+	if (root < 0) {
+		*l = -1;
+		*r = -1;
+	} else if (ost_less(t, root, n)) {
+		ost_split(t, t[root].right, n, &t[root].right, r);
+		*l = root;
+		ost_update(t, root);
+	} else {
+		ost_split(t, t[root].left, n, l, &t[root].left);
+		*r = root;
+		ost_update(t, root);
+	}
+}
+
+static int ost_insert(ost_node * t, int root, int n) {
+	if (root < 0)
+		return n;
+	if (t[n].prio > t[root].prio) {
+		ost_split(t, root, n, &t[n].left, &t[n].right);
+		ost_update(t, n);
+		return n;
+	}
+	if (ost_less(t, n, root))
+		t[root].left = ost_insert(t, t[root].left, n);
+	else
+		t[root].right = ost_insert(t, t[root].right, n);
+	ost_update(t, root);
+	return root;
+}
+
+static int ost_erase(ost_node * t, int root, int n) {
+	if (root == n)
+		return ost_merge(t, t[n].left, t[n].right);
+	if (ost_less(t, n, root))
+		t[root].left = ost_erase(t, t[root].left, n);
+	else
+		t[root].right = ost_erase(t, t[root].right, n);
+	ost_update(t, root);
+	return root;
+}
+
+// returns the k-th smallest value (0 based) in the tree
+static double ost_select(ost_node * t, int root, int k) {
+	int cur = root;
+	while (cur >= 0) {
+		int ls = ost_size(t, t[cur].left);
+		if (k < ls) {
+			cur = t[cur].left;
+		} else if (k == ls) {
+			return t[cur].val;
+		} else {
+			k -= ls + 1;
+			cur = t[cur].right;
+		}
+	}
+	return 0.0;
+}
+
+/*
+ * k-th smallest absolute deviation from the median m of the N lowest values in
+ * the tree (the finite ones, NAN sorts last). With those sorted as a[],
+ * p = n / 2, the deviations m - a[p-1-j] and a[p+j] - m form two
+ * non-decreasing sequences, so the k-th of their union is found by bisection.
+ */
+static double ost_dev_select(med_chan * c, int n, double m, int k) {
+	int p = n / 2;
+	int na = p;
+	int nb = n - p;
+	int a0 = 0, b0 = 0;
+
+	while (1) {
+		if (na - a0 <= 0)
+			return ost_select(c->node, c->root, p + b0 + k) - m;
+		if (nb - b0 <= 0)
+			return m - ost_select(c->node, c->root, p - 1 - (a0 + k));
+		if (k == 0) {
+			double da = m - ost_select(c->node, c->root, p - 1 - a0);
+			double db = ost_select(c->node, c->root, p + b0) - m;
+			return (da < db) ? da : db;
+		}
+		int ia = (k + 1) / 2;
+		if (ia > na - a0)
+			ia = na - a0;
+		int ib = (k + 1) - ia;
+		if (ib > nb - b0) {
+			ib = nb - b0;
+			ia = (k + 1) - ib;
+		}
+		double da = m - ost_select(c->node, c->root, p - 1 - (a0 + ia - 1));
+		double db = ost_select(c->node, c->root, p + b0 + ib - 1) - m;
+		if (da <= db) {
+			a0 += ia;
+			k -= ia;
+		} else {
+			b0 += ib;
+			k -= ib;
+		}
+	}
+}
+
+/*
+ * function: med_init
+ * purpose: allocates the ring buffers and order statistic trees for OUT_NUM channels
+ * inputs: - med_filt * MF
+ * 		   - int WIN_LEN
+ * 		   - double N_SIGMA
+ * returns: 0 - success, -1 - failure
+ */
+int med_init(med_filt * mf, int win_len, double n_sigma) {
+	if (mf == NULL || win_len < 3 || win_len % 2 == 0) {
+		printf("Error: med_init needs an odd window length >= 3!\n");
+		return -1;
+	}
+	memset(mf, 0, sizeof(med_filt));
+	mf->win_len = win_len;
+	mf->n_sigma = n_sigma;
+
+	unsigned int seed = 2463534242u;
+	int i, j;
+	for (i = 0; i < OUT_NUM; i++) {
+		mf->chan[i].node = (ost_node *) malloc(sizeof(ost_node) * win_len);
+		if (mf->chan[i].node == NULL ) {
+			printf("Error: med_init failed mem allocation on %d channel!\n", i);
+			med_free(mf);
+			return -1;
+		}
+		for (j = 0; j < win_len; j++) {
+			// xorshift32 priorities, fixed seed keeps runs reproducible
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			mf->chan[i].node[j].prio = seed;
+		}
+		mf->chan[i].root = -1;
+	}
+	return 0;
+} /* int med_init */
+
+/*
+ * function: med_free
+ * purpose: releases memory held by a med_filt
+ * inputs: - med_filt * MF
+ * returns: 0 - success, -1 - failure
+ */
+int med_free(med_filt * mf) {
+	if (mf == NULL )
+		return -1;
+	int i;
+	for (i = 0; i < OUT_NUM; i++) {
+		free(mf->chan[i].node);
+		mf->chan[i].node = NULL;
+	}
+	return 0;
+} /* int med_free */
+
+/*
+ * pushes one sample per channel into the windows. The first sample is replicated
+ * across the whole window so output starts immediately with edge padding.
+ */
+static void med_push(med_filt * mf, sig_type input) {
+	int i, j;
+	for (i = 0; i < OUT_NUM; i++) {
+		med_chan * c = &mf->chan[i];
+		if (!mf->primed) {
+			for (j = 0; j < mf->win_len; j++) {
+				c->node[j].val = input[i];
+				c->node[j].left = -1;
+				c->node[j].right = -1;
+				c->node[j].size = 1;
+				c->root = ost_insert(c->node, c->root, j);
+			}
+			c->head = 0;
+			c->n_nan = isnan(input[i]) ? mf->win_len : 0;
+		} else {
+			c->n_nan += isnan(input[i]) - isnan(c->node[c->head].val);
+			c->root = ost_erase(c->node, c->root, c->head);
+			c->node[c->head].val = input[i];
+			c->node[c->head].left = -1;
+			c->node[c->head].right = -1;
+			c->node[c->head].size = 1;
+			c->root = ost_insert(c->node, c->root, c->head);
+			c->head = (c->head + 1 == mf->win_len) ? 0 : c->head + 1;
+		}
+	}
+	mf->primed = 1;
+}
+
+/*
+ * function: median_process
+ * purpose: pushes one sample per channel and returns the window medians.
+ * 			output lags the input by (WIN_LEN - 1) / 2 samples. NAN samples are
+ * 			left out, an all NAN window gives NAN.
+ * inputs: - med_filt * MF
+ * 		   - sig_type INPUT
+ * 		   - sig_type OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int median_process(med_filt * mf, sig_type input, sig_type output) {
+	if (mf == NULL || mf->win_len == 0)
+		return -1;
+	med_push(mf, input);
+
+	int i;
+	for (i = 0; i < OUT_NUM; i++) {
+		med_chan * c = &mf->chan[i];
+		int n = mf->win_len - c->n_nan;
+		output[i] = (n > 0) ? ost_select(c->node, c->root, n / 2) : NAN;
+	}
+	return 0;
+} /* int median_process */
+
+/*
+ * function: hampel_process
+ * purpose: pushes one sample per channel and returns the centre sample of each
+ * 			window, replaced by the window median when it lies more than
+ * 			N_SIGMA * 1.4826 * MAD away from it. output lags by (WIN_LEN - 1) / 2.
+ * 			NAN samples are left out of the median and MAD, a NAN centre
+ * 			sample passes through.
+ * inputs: - med_filt * MF
+ * 		   - sig_type INPUT
+ * 		   - sig_type OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int hampel_process(med_filt * mf, sig_type input, sig_type output) {
+	if (mf == NULL || mf->win_len == 0)
+		return -1;
+	med_push(mf, input);
+
+	int half = mf->win_len / 2;
+	int i;
+	for (i = 0; i < OUT_NUM; i++) {
+		med_chan * c = &mf->chan[i];
+
+		// head now points at the oldest sample, the centre is half slots on
+		int centre = c->head + half;
+		if (centre >= mf->win_len)
+			centre -= mf->win_len;
+		double x = c->node[centre].val;
+
+		// a NAN centre passes through, the others are left out of m and mad
+		int n = mf->win_len - c->n_nan;
+		if (isnan(x) || n == 0) {
+			output[i] = x;
+			continue;
+		}
+		double m = ost_select(c->node, c->root, n / 2);
+		double mad = ost_dev_select(c, n, m, n / 2);
+
+		if (fabs(x - m) > mf->n_sigma * MAD_SCALE * mad) {
+			output[i] = m;
+			mf->n_outliers[i]++;
+		} else {
+			output[i] = x;
+		}
+	}
+	return 0;
+} /* int hampel_process */
+
+/*
+ * function: hampel_block
+ * purpose: runs hampel_process over a block of samples. IN and OUT may alias.
+ * inputs: - med_filt * MF
+ * 		   - sig_type * IN
+ * 		   - sig_type * OUT
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int hampel_block(med_filt * mf, sig_type * in, sig_type * out, int len) {
+	int n;
+	for (n = 0; n < len; n++) {
+		sig_type x;
+		memcpy(x, in[n], sizeof(sig_type));
+		if (hampel_process(mf, x, out[n]) == -1)
+			return -1;
+	}
+	return 0;
+} /* int hampel_block */
+
+/*
+ * function: med_bench
+ * purpose: times hampel_block on a synthetic spiky signal and reports the cost
+ * 			per multi-channel sample. Intended for sizing large windows.
+ * inputs: - int WIN_LEN
+ * 		   - int N
+ * 		   - double * NS_PER_SAMPLE
+ * returns: 0 - success, -1 - failure
+ */
+int med_bench(int win_len, int n, double * ns_per_sample) {
+	med_filt mf;
+	if (med_init(&mf, win_len, 3.0) == -1)
+		return -1;
+
+	sig_type * buf = (sig_type *) malloc(sizeof(sig_type) * n);
+	if (buf == NULL ) {
+		med_free(&mf);
+		return -1;
+	}
+	int i, j;
+	for (i = 0; i < n; i++)
+		for (j = 0; j < OUT_NUM; j++)
+			buf[i][j] = sin(2 * pi * 0.001 * i) + ((i % 97 == 0) ? 5.0 : 0.0);
+
+	struct timespec t0, t1;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	int err = hampel_block(&mf, buf, buf, n);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	*ns_per_sample = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / n;
+	free(buf);
+	med_free(&mf);
+	return err;
+} /* int med_bench */
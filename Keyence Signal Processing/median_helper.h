@@ -0,0 +1,108 @@
+/*
+ * median_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef MEDIAN_HELPER_H_
+#define MEDIAN_HELPER_H_
+
+#include <time.h>
+#include "sig_support.c"
+
+// scale factor from MAD to standard deviation for gaussian data
+#define MAD_SCALE 1.4826
+
+// treap node, one per ring slot. ordered by (val, slot) so duplicates are distinct
+typedef struct {
+	double val;
+	int left;
+	int right;
+	int size;
+	unsigned int prio;
+} ost_node;
+
+// window state for a single channel
+typedef struct {
+	ost_node * node;
+	int root;
+	int head;
+	// NAN samples in the window
+	int n_nan;
+} med_chan;
+
+// sliding median / Hampel state for OUT_NUM channels
+typedef struct {
+	int win_len;
+	int primed;
+	double n_sigma;
+	long n_outliers[OUT_NUM];
+	med_chan chan[OUT_NUM];
+} med_filt;
+
+/*
+ * function: med_init
+ * purpose: allocates the ring buffers and order statistic trees for OUT_NUM channels
+ * inputs: - med_filt * MF
+ * 		   - int WIN_LEN (odd, >= 3)
+ * 		   - double N_SIGMA (Hampel threshold, ignored by median_process)
+ * returns: 0 - success, -1 - failure
+ */
+int med_init(med_filt * mf, int win_len, double n_sigma);
+
+/*
+ * function: med_free
+ * purpose: releases memory held by a med_filt
+ * inputs: - med_filt * MF
+ * returns: 0 - success, -1 - failure
+ */
+int med_free(med_filt * mf);
+
+/*
+ * function: median_process
+ * purpose: pushes one sample per channel and returns the window medians.
+ * 			output lags the input by (WIN_LEN - 1) / 2 samples. NAN samples are
+ * 			left out, an all NAN window gives NAN.
+ * inputs: - med_filt * MF
+ * 		   - sig_type INPUT
+ * 		   - sig_type OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int median_process(med_filt * mf, sig_type input, sig_type output);
+
+/*
+ * function: hampel_process
+ * purpose: Hampel outlier rejection. Returns the centre sample of each window,
+ * 			replaced by the window median when it is more than
+ * 			N_SIGMA * 1.4826 * MAD away from it. Run ahead of filter_process to
+ * 			keep height spikes out of the FIR. NAN samples are left out of the
+ * 			median and MAD, a NAN centre sample passes through.
+ * inputs: - med_filt * MF
+ * 		   - sig_type INPUT
+ * 		   - sig_type OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int hampel_process(med_filt * mf, sig_type input, sig_type output);
+
+/*
+ * function: hampel_block
+ * purpose: runs hampel_process over a block of samples. IN and OUT may alias.
+ * inputs: - med_filt * MF
+ * 		   - sig_type * IN
+ * 		   - sig_type * OUT
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int hampel_block(med_filt * mf, sig_type * in, sig_type * out, int len);
+
+/*
+ * function: med_bench
+ * purpose: times hampel_block on a synthetic spiky signal
+ * inputs: - int WIN_LEN
+ * 		   - int N
+ * 		   - double * NS_PER_SAMPLE
+ * returns: 0 - success, -1 - failure
+ */
+int med_bench(int win_len, int n, double * ns_per_sample);
+
+#endif /* MEDIAN_HELPER_H_ */
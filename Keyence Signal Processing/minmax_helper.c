@@ -0,0 +1,386 @@
+/*
+ * minmax_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: min / max over sliding windows and whole arrays. The sliding
+ *      		 tracker keeps a monotonic deque per channel: a sample is dropped
+ *      		 as soon as a newer one beats it, so each sample is pushed and
+ *      		 popped at most once and the window extreme is always at the
+ *      		 front. Cost is O(1) amortised per sample whatever the window,
+ *      		 giving continuous peak-to-peak height. NAN samples (e.g. gaps
+ *      		 from resamp_push) are skipped.
+ *
+ *      		 mm_reduce keeps MM_LANES independent running extremes, seeded
+ *      		 with the first non NAN value, so the updates are plain compares
+ *      		 (minsd / maxsd and cmov, no branches) with no chain between
+ *      		 lanes, then merges the lanes, lowest index winning ties. GCC 12
+ *      		 does not vectorise the loop at the default x86-64 target: the
+ *      		 index has to follow the value select, which -fopt-info-vec
+ *      		 reports as control flow in loop.
+ */
+
+#include "minmax_helper.h"
+
+/*
+ * function: mm_init
+ * purpose: allocates a sliding min / max tracker over WIN_LEN samples
+ * inputs: - mm_track * MT
+ * 		   - int WIN_LEN
+ * returns: 0 - success, -1 - failure
+ */
+int mm_init(mm_track * mt, int win_len) {
+	if (mt == NULL || win_len < 1 || win_len > (1 << 30)) {
+		printf("Error: mm_init invalid parameters!\n");
+		return -1;
+	}
+	memset(mt, 0, sizeof(mm_track));
+	int cap = 1;
+	while (cap < win_len)
+		cap <<= 1;
+	mt->win_len = win_len;
+	mt->mask = cap - 1;
+
+	size_t n = (size_t) cap * OUT_NUM;
+	mt->max_idx = (long *) malloc(sizeof(long) * n);
+	mt->max_val = (double *) malloc(sizeof(double) * n);
+	mt->min_idx = (long *) malloc(sizeof(long) * n);
+	mt->min_val = (double *) malloc(sizeof(double) * n);
+	if (mt->max_idx == NULL || mt->max_val == NULL || mt->min_idx == NULL
+			|| mt->min_val == NULL ) {
+		printf("Error: mm_init failed mem allocation!\n");
+		mm_free(mt);
+		return -1;
+	}
+	return 0;
+} /* int mm_init */
+
+/*
+ * function: mm_free
+ * purpose: releases memory held by an mm_track
+ * inputs: - mm_track * MT
+ * returns: 0 - success, -1 - failure
+ */
+int mm_free(mm_track * mt) {
+	if (mt == NULL )
+		return -1;
+	free(mt->max_idx);
+	free(mt->max_val);
+	free(mt->min_idx);
+	free(mt->min_val);
+	memset(mt, 0, sizeof(mm_track));
+	return 0;
+} /* int mm_free */
+
+/*
+ * function: mm_process
+ * purpose: pushes one sample per channel and returns the max and min of the
+ * 			last WIN_LEN samples (fewer while filling). A channel whose whole
+ * 			window is NAN returns NAN.
+ * inputs: - mm_track * MT
+ * 		   - sig_type INPUT
+ * 		   - sig_type MAX
+ * 		   - sig_type MIN
+ * returns: 0 - success, -1 - failure
+ */
+int mm_process(mm_track * mt, sig_type input, sig_type max, sig_type min) {
+	if (mt == NULL || mt->max_idx == NULL )
+		return -1;
+
+	long n = mt->n++;
+	long expired = n - mt->win_len;
+	unsigned long mask = (unsigned long) mt->mask;
+	size_t cap = (size_t) mask + 1;
+	int j;
+	for (j = 0; j < OUT_NUM; j++) {
+		long * mi = mt->max_idx + j * cap;
+		double * mv = mt->max_val + j * cap;
+		long * ni = mt->min_idx + j * cap;
+		double * nv = mt->min_val + j * cap;
+		unsigned long h, t;
+		double x = input[j];
+
+		// max: newer samples at least as large make older ones irrelevant
+		h = mt->max_head[j];
+		t = mt->max_tail[j];
+		// expire first so the push never needs more than WIN_LEN entries
+		if (t != h && mi[h & mask] <= expired)
+			h++;
+		if (!isnan(x)) {
+			while (t != h && mv[(t - 1) & mask] <= x)
+				t--;
+			mi[t & mask] = n;
+			mv[t & mask] = x;
+			t++;
+		}
+		max[j] = (t != h) ? mv[h & mask] : NAN;
+		mt->max_head[j] = h;
+		mt->max_tail[j] = t;
+
+		// min: mirror image
+		h = mt->min_head[j];
+		t = mt->min_tail[j];
+		// expire first so the push never needs more than WIN_LEN entries
+		if (t != h && ni[h & mask] <= expired)
+			h++;
+		if (!isnan(x)) {
+			while (t != h && nv[(t - 1) & mask] >= x)
+				t--;
+			ni[t & mask] = n;
+			nv[t & mask] = x;
+			t++;
+		}
+		min[j] = (t != h) ? nv[h & mask] : NAN;
+		mt->min_head[j] = h;
+		mt->min_tail[j] = t;
+	}
+	return 0;
+} /* int mm_process */
+
+/*
+ * function: mm_block
+ * purpose: runs mm_process over a block and writes the sliding peak-to-peak
+ * 			(max - min) of every sample. IN and P2P may alias.
+ * inputs: - mm_track * MT
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * 		   - sig_type * P2P
+ * returns: 0 - success, -1 - failure
+ */
+int mm_block(mm_track * mt, sig_type * in, int len, sig_type * p2p) {
+	int n, j;
+	for (n = 0; n < len; n++) {
+		sig_type mx, mn;
+		if (mm_process(mt, in[n], mx, mn) == -1)
+			return -1;
+		for (j = 0; j < OUT_NUM; j++)
+			p2p[n][j] = mx[j] - mn[j];
+	}
+	return 0;
+} /* int mm_block */
+
+/*
+ * function: mm_reduce
+ * purpose: min, max and their first positions over a contiguous array.
+ * 			NAN entries are ignored; an all NAN array gives indices of -1.
+ * inputs: - double * X
+ * 		   - long LEN
+ * 		   - double * MIN
+ * 		   - double * MAX
+ * 		   - long * IMIN (may be NULL)
+ * 		   - long * IMAX (may be NULL)
+ * returns: 0 - success, -1 - failure
+ */
+int mm_reduce(double * x, long len, double * min, double * max, long * imin,
+		long * imax) {
+	if (x == NULL || min == NULL || max == NULL || len < 1)
+		return -1;
+
+	// seed every lane with the first non NAN value, after that plain
+	// compares skip NANs (they compare false) and accept infinities
+	long i = 0;
+	while (i < len && x[i] != x[i])
+		i++;
+	if (i == len) {
+		*min = NAN;
+		*max = NAN;
+		if (imin != NULL )
+			*imin = -1;
+		if (imax != NULL )
+			*imax = -1;
+		return 0;
+	}
+	double lmin[MM_LANES], lmax[MM_LANES];
+	long limin[MM_LANES], limax[MM_LANES];
+	int l;
+	for (l = 0; l < MM_LANES; l++) {
+		lmin[l] = x[i];
+		lmax[l] = x[i];
+		limin[l] = i;
+		limax[l] = i;
+	}
+
+	// branch free lane updates, independent across lanes
+	for (i++; i + MM_LANES <= len; i += MM_LANES) {
+		for (l = 0; l < MM_LANES; l++) {
+			double v = x[i + l];
+			int lt = v < lmin[l];
+			int gt = v > lmax[l];
+			lmin[l] = lt ? v : lmin[l];
+			limin[l] = lt ? i + l : limin[l];
+			lmax[l] = gt ? v : lmax[l];
+			limax[l] = gt ? i + l : limax[l];
+		}
+	}
+	for (l = 0; i < len; i++, l++) {
+		if (x[i] < lmin[l]) {
+			lmin[l] = x[i];
+			limin[l] = i;
+		}
+		if (x[i] > lmax[l]) {
+			lmax[l] = x[i];
+			limax[l] = i;
+		}
+	}
+
+	// merge lanes, first position wins ties
+	double bmin = lmin[0], bmax = lmax[0];
+	long bimin = limin[0], bimax = limax[0];
+	for (l = 1; l < MM_LANES; l++) {
+		if (lmin[l] < bmin || (lmin[l] == bmin && limin[l] < bimin)) {
+			bmin = lmin[l];
+			bimin = limin[l];
+		}
+		if (lmax[l] > bmax || (lmax[l] == bmax && limax[l] < bimax)) {
+			bmax = lmax[l];
+			bimax = limax[l];
+		}
+	}
+	*min = bmin;
+	*max = bmax;
+	if (imin != NULL )
+		*imin = bimin;
+	if (imax != NULL )
+		*imax = bimax;
+	return 0;
+} /* int mm_reduce */
+
+/*
+ * function: mm_reduce_sig
+ * purpose: per channel min, max and their first positions over a sig_type
+ * 			array such as PB, in a single pass. NAN entries are ignored.
+ * inputs: - sig_type * X
+ * 		   - int LEN
+ * 		   - sig_type MIN
+ * 		   - sig_type MAX
+ * 		   - int * IMIN (OUT_NUM values, may be NULL)
+ * 		   - int * IMAX (OUT_NUM values, may be NULL)
+ * returns: 0 - success, -1 - failure
+ */
+int mm_reduce_sig(sig_type * x, int len, sig_type min, sig_type max, int * imin,
+		int * imax) {
+	if (x == NULL || min == NULL || max == NULL || len < 1)
+		return -1;
+
+	int jmin[OUT_NUM], jmax[OUT_NUM];
+	int i, j;
+	for (j = 0; j < OUT_NUM; j++) {
+		min[j] = INFINITY;
+		max[j] = -INFINITY;
+		jmin[j] = -1;
+		jmax[j] = -1;
+	}
+	for (i = 0; i < len; i++) {
+		for (j = 0; j < OUT_NUM; j++) {
+			double v = x[i][j];
+			int lt = v < min[j] || (jmin[j] == -1 && v == v);
+			int gt = v > max[j] || (jmax[j] == -1 && v == v);
+			min[j] = lt ? v : min[j];
+			jmin[j] = lt ? i : jmin[j];
+			max[j] = gt ? v : max[j];
+			jmax[j] = gt ? i : jmax[j];
+		}
+	}
+	for (j = 0; j < OUT_NUM; j++) {
+		if (jmin[j] == -1) {
+			min[j] = NAN;
+			max[j] = NAN;
+		}
+		if (imin != NULL )
+			imin[j] = jmin[j];
+		if (imax != NULL )
+			imax[j] = jmax[j];
+	}
+	return 0;
+} /* int mm_reduce_sig */
+
+static double mm_elapsed_ns(struct timespec * t0, struct timespec * t1) {
+	return (t1->tv_sec - t0->tv_sec) * 1e9 + (t1->tv_nsec - t0->tv_nsec);
+}
+
+/*
+ * function: mm_bench
+ * purpose: times the sliding tracker and the block reduction against naive
+ * 			scans on a synthetic signal, and checks that they agree.
+ * 			Sliding costs are per multi-channel sample, reduction costs per
+ * 			array element.
+ * inputs: - int WIN_LEN
+ * 		   - int N
+ * 		   - double * NS_DEQUE
+ * 		   - double * NS_NAIVE
+ * 		   - double * NS_REDUCE
+ * 		   - double * NS_REDUCE_NAIVE
+ * returns: 0 - success, -1 - failure or disagreement
+ */
+int mm_bench(int win_len, int n, double * ns_deque, double * ns_naive,
+		double * ns_reduce, double * ns_reduce_naive) {
+	mm_track mt;
+	if (n < 1 || mm_init(&mt, win_len) == -1)
+		return -1;
+
+	sig_type * buf = (sig_type *) malloc(sizeof(sig_type) * n);
+	sig_type * p2p = (sig_type *) malloc(sizeof(sig_type) * n);
+	double * flat = (double *) malloc(sizeof(double) * n);
+	if (buf == NULL || p2p == NULL || flat == NULL ) {
+		free(buf);
+		free(p2p);
+		free(flat);
+		mm_free(&mt);
+		return -1;
+	}
+	int i, j, k;
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < OUT_NUM; j++)
+			buf[i][j] = sin(2 * pi * 0.001 * (j + 1) * i) + 0.1 * sin(0.37 * i);
+		flat[i] = buf[i][0];
+	}
+
+	struct timespec t0, t1;
+	int err = 0;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	err |= mm_block(&mt, buf, n, p2p);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	*ns_deque = mm_elapsed_ns(&t0, &t1) / n;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0; i < n && err == 0; i++) {
+		int first = (i + 1 < win_len) ? 0 : i + 1 - win_len;
+		for (j = 0; j < OUT_NUM; j++) {
+			double mx = buf[first][j], mn = buf[first][j];
+			for (k = first + 1; k <= i; k++) {
+				mx = (buf[k][j] > mx) ? buf[k][j] : mx;
+				mn = (buf[k][j] < mn) ? buf[k][j] : mn;
+			}
+			if (mx - mn != p2p[i][j])
+				err = -1;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	*ns_naive = mm_elapsed_ns(&t0, &t1) / n;
+
+	double mn, mx;
+	long imn, imx;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	err |= mm_reduce(flat, n, &mn, &mx, &imn, &imx);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	*ns_reduce = mm_elapsed_ns(&t0, &t1) / n;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	long nmn = 0, nmx = 0;
+	for (i = 1; i < n; i++) {
+		if (flat[i] < flat[nmn])
+			nmn = i;
+		if (flat[i] > flat[nmx])
+			nmx = i;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	*ns_reduce_naive = mm_elapsed_ns(&t0, &t1) / n;
+	if (nmn != imn || nmx != imx)
+		err = -1;
+
+	free(buf);
+	free(p2p);
+	free(flat);
+	mm_free(&mt);
+	return (err == 0) ? 0 : -1;
+} /* int mm_bench */
@@ -0,0 +1,117 @@
+/*
+ * minmax_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef MINMAX_HELPER_H_
+#define MINMAX_HELPER_H_
+
+#include <time.h>
+#include "sig_support.c"
+
+#define MM_LANES 8
+
+typedef struct {
+	int win_len;
+	int mask;
+	long n;
+	// deque rings, CAP = MASK + 1 entries per channel, oldest at head
+	long * max_idx;
+	double * max_val;
+	long * min_idx;
+	double * min_val;
+	unsigned long max_head[OUT_NUM];
+	unsigned long max_tail[OUT_NUM];
+	unsigned long min_head[OUT_NUM];
+	unsigned long min_tail[OUT_NUM];
+} mm_track;
+
+/*
+ * function: mm_init
+ * purpose: allocates a sliding min / max tracker over WIN_LEN samples
+ * inputs: - mm_track * MT
+ * 		   - int WIN_LEN
+ * returns: 0 - success, -1 - failure
+ */
+int mm_init(mm_track * mt, int win_len);
+
+/*
+ * function: mm_free
+ * purpose: releases memory held by an mm_track
+ * inputs: - mm_track * MT
+ * returns: 0 - success, -1 - failure
+ */
+int mm_free(mm_track * mt);
+
+/*
+ * function: mm_process
+ * purpose: pushes one sample per channel and returns the max and min of the
+ * 			last WIN_LEN samples (fewer while filling). A channel whose whole
+ * 			window is NAN returns NAN.
+ * inputs: - mm_track * MT
+ * 		   - sig_type INPUT
+ * 		   - sig_type MAX
+ * 		   - sig_type MIN
+ * returns: 0 - success, -1 - failure
+ */
+int mm_process(mm_track * mt, sig_type input, sig_type max, sig_type min);
+
+/*
+ * function: mm_block
+ * purpose: runs mm_process over a block and writes the sliding peak-to-peak
+ * 			(max - min) of every sample. IN and P2P may alias.
+ * inputs: - mm_track * MT
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * 		   - sig_type * P2P
+ * returns: 0 - success, -1 - failure
+ */
+int mm_block(mm_track * mt, sig_type * in, int len, sig_type * p2p);
+
+/*
+ * function: mm_reduce
+ * purpose: min, max and their first positions over a contiguous array.
+ * 			NAN entries are ignored; an all NAN array gives indices of -1.
+ * inputs: - double * X
+ * 		   - long LEN
+ * 		   - double * MIN
+ * 		   - double * MAX
+ * 		   - long * IMIN (may be NULL)
+ * 		   - long * IMAX (may be NULL)
+ * returns: 0 - success, -1 - failure
+ */
+int mm_reduce(double * x, long len, double * min, double * max, long * imin,
+		long * imax);
+
+/*
+ * function: mm_reduce_sig
+ * purpose: per channel min, max and their first positions over a sig_type
+ * 			array such as PB, in a single pass. NAN entries are ignored.
+ * inputs: - sig_type * X
+ * 		   - int LEN
+ * 		   - sig_type MIN
+ * 		   - sig_type MAX
+ * 		   - int * IMIN (OUT_NUM values, may be NULL)
+ * 		   - int * IMAX (OUT_NUM values, may be NULL)
+ * returns: 0 - success, -1 - failure
+ */
+int mm_reduce_sig(sig_type * x, int len, sig_type min, sig_type max, int * imin,
+		int * imax);
+
+/*
+ * function: mm_bench
+ * purpose: times the sliding tracker and the block reduction against naive
+ * 			scans on a synthetic signal, and checks that they agree
+ * inputs: - int WIN_LEN
+ * 		   - int N
+ * 		   - double * NS_DEQUE
+ * 		   - double * NS_NAIVE
+ * 		   - double * NS_REDUCE
+ * 		   - double * NS_REDUCE_NAIVE
+ * returns: 0 - success, -1 - failure or disagreement
+ */
+int mm_bench(int win_len, int n, double * ns_deque, double * ns_naive,
+		double * ns_reduce, double * ns_reduce_naive);
+
+#endif /* MINMAX_HELPER_H_ */
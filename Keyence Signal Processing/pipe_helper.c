@@ -0,0 +1,593 @@
+/*
+ * pipe_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: configurable processing pipeline. Stages are chained from a config
+ *      		 file (one stage per line) and executed a block at a time. Runs of
+ *      		 adjacent per-sample stages are fused, each sample goes through the
+ *      		 whole run before the next one is touched, so intermediate values
+ *      		 never leave registers / L1. Block stages (spectrum, sinks) see the
+ *      		 output of the preceding run once per block.
+ *
+ *      		 Config lines ('#' starts a comment):
+ *      		   rate <fs>
+ *      		   block <samples>
+ *      		   tune <cache prefix | off>
+ *      		   hampel <win_len> <n_sigma>
+ *      		   median <win_len>
+ *      		   fir <f_low> <f_high> <win_type> <filt_type> <taps>
+ *      		   anc <nlms|rls> <ref_ch (0 .. OUT_NUM - 1)> <taps> <step> [<block>]
+ *      		   cic <stages> <decim> <delay> <q_scale> <max_in> [<comp_len> <f_pass> <win_type>]
+ *      		   event <deriv|cusum> <thresh> <hyst> <span> [<path>]
+ *      		   spectrum <fft_len> <hop> [<shm name>]
+ *      		   sink file <path>
+ *      		   sink shm <name>
+ *      		   sink callback
+ *
+ *      		 FIR stages run the direct form unless a "tune" line (or
+ *      		 pipe_set_tune) names a cache prefix, then the implementation
+ *      		 tune_select finds fastest at the block size; an FFT convolution
+ *      		 runs as a block stage.
+ *
+ *      		 Event stages pass samples through unchanged; the events found
+ *      		 in a block go to the event callback and, if given, are appended
+ *      		 to a text file as "time index ch dir mag" lines.
+ */
+
+#include "pipe_helper.h"
+
+/*
+ * function: pipe_init
+ * purpose: initializes an empty pipeline
+ * inputs: - pipe_graph * PG
+ * 		   - double FS
+ * 		   - int BLOCK_LEN
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_init(pipe_graph * pg, double fs, int block_len) {
+	if (pg == NULL || fs <= 0.0 || block_len < 1) {
+		printf("Error: pipe_init invalid parameters!\n");
+		return -1;
+	}
+	memset(pg, 0, sizeof(pipe_graph));
+	pg->fs = fs;
+	pg->block_len = block_len;
+	return 0;
+} /* int pipe_init */
+
+/*
+ * function: pipe_set_tune
+ * purpose: sets the tune_select cache prefix for FIR stages added later,
+ * 			the autotuning benchmark runs when a stage is added on a cache miss
+ * inputs: - pipe_graph * PG
+ * 		   - char * PREFIX (NULL or "": no tuning, direct form)
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_set_tune(pipe_graph * pg, char * prefix) {
+	if (pg == NULL || (prefix != NULL && strlen(prefix) >= PIPE_LINE_LEN)) {
+		printf("Error: pipe_set_tune invalid parameters!\n");
+		return -1;
+	}
+	strcpy(pg->tune, (prefix == NULL) ? "" : prefix);
+	return 0;
+} /* int pipe_set_tune */
+
+/*
+ * function: pipe_set_callback
+ * purpose: sets the function that receives spectra and "sink callback" output
+ * inputs: - pipe_graph * PG
+ * 		   - pipe_cb CB
+ * 		   - void * CTX
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_set_callback(pipe_graph * pg, pipe_cb cb, void * ctx) {
+	if (pg == NULL )
+		return -1;
+	pg->cb = cb;
+	pg->cb_ctx = ctx;
+	return 0;
+} /* int pipe_set_callback */
+
+/*
+ * function: pipe_set_event_callback
+ * purpose: sets the function that receives the events of event stages
+ * inputs: - pipe_graph * PG
+ * 		   - pipe_ev_cb CB
+ * 		   - void * CTX
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_set_event_callback(pipe_graph * pg, pipe_ev_cb cb, void * ctx) {
+	if (pg == NULL )
+		return -1;
+	pg->ev_cb = cb;
+	pg->ev_ctx = ctx;
+	return 0;
+} /* int pipe_set_event_callback */
+
+// sample rate seen by the next stage added
+static double pipe_rate(pipe_graph * pg) {
+	if (pg->n_stages == 0)
+		return pg->fs;
+	pipe_stage * last = &pg->stage[pg->n_stages - 1];
+	if (last->kind == PIPE_CIC)
+		return last->fs / ((cic_filt *) last->state)->decim;
+	return last->fs;
+}
+
+static int pipe_spec_init(pipe_spec * ps, int fft_len, int hop) {
+	int j;
+	memset(ps, 0, sizeof(pipe_spec));
+	ps->fft_len = fft_len;
+	ps->hop = hop;
+	for (j = 0; j < OUT_NUM; j++) {
+		ps->frame[j] = (double *) calloc(fft_len, sizeof(double));
+		if (ps->frame[j] == NULL )
+			return -1;
+	}
+	ps->scratch = (double *) fftw_malloc(sizeof(double) * fft_len);
+	ps->out = (fftw_complex *) fftw_malloc(
+			sizeof(fftw_complex) * (fft_len / 2 + 1));
+	ps->pb = (sig_type *) malloc(sizeof(sig_type) * (fft_len / 2 + 1));
+	if (ps->scratch == NULL || ps->out == NULL || ps->pb == NULL )
+		return -1;
+	ps->plan = plan_get(fft_len, PLAN_R2C, 1, 1);
+	return (ps->plan == NULL ) ? -1 : 0;
+}
+
+static void pipe_spec_free(pipe_spec * ps) {
+	int j;
+	for (j = 0; j < OUT_NUM; j++)
+		free(ps->frame[j]);
+	fftw_free(ps->scratch);
+	fftw_free(ps->out);
+	free(ps->pb);
+	if (ps->shm.hdr != NULL )
+		shm_pub_close(&ps->shm);
+}
+
+// designs the FIR of a "fir" line and sets up its fastest implementation
+static int pipe_fir_init(pipe_graph * pg, pipe_stage * st, double * a) {
+	fir_filt ff;
+	if (fir_design(&ff, a[0], a[1], st->fs, (int) a[2], (int) a[3], (int) a[4])
+			== -1)
+		return -1;
+	int L = ff.len;
+	double * taps = (double *) malloc(sizeof(double) * L);
+	if (taps == NULL ) {
+		fir_free(&ff);
+		return -1;
+	}
+	int k;
+	for (k = 0; k < L; k++)
+		taps[k] = ff.rtaps[L - 1 - k];
+	fir_free(&ff);
+
+	int impl = (pg->tune[0] == '\0') ? TUNE_DIRECT :
+			tune_select(taps, L, pg->block_len, TUNE_TOL, pg->tune);
+	int err = (impl == -1) ? -1 :
+			tune_init((tune_filt *) st->state, impl, taps, L, pg->block_len);
+	st->per_sample = (impl != TUNE_FFT);
+	free(taps);
+	return err;
+}
+
+/*
+ * function: pipe_add_stage
+ * purpose: parses one config line and appends the stage it describes. "rate"
+ * 			and "block" lines update the pipeline settings instead.
+ * inputs: - pipe_graph * PG
+ * 		   - char * LINE
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_add_stage(pipe_graph * pg, char * line) {
+	char name[32];
+	char arg[PIPE_LINE_LEN];
+	double a[8];
+	int n;
+
+	if (pg == NULL || line == NULL )
+		return -1;
+	if (sscanf(line, "%31s", name) != 1 || name[0] == '#')
+		return 0;
+
+	if (strcmp(name, "rate") == 0) {
+		if (pg->n_stages != 0 || sscanf(line, "%*s %lf", &pg->fs) != 1
+				|| pg->fs <= 0.0)
+			goto bad;
+		return 0;
+	}
+	if (strcmp(name, "block") == 0) {
+		// must precede the stages, shm sinks size their slots from it
+		if (pg->n_stages != 0 || pg->buf[0] != NULL
+				|| sscanf(line, "%*s %d", &pg->block_len) != 1
+				|| pg->block_len < 1)
+			goto bad;
+		return 0;
+	}
+
+	if (strcmp(name, "tune") == 0) {
+		if (sscanf(line, "%*s %255s", arg) != 1)
+			goto bad;
+		return pipe_set_tune(pg, (strcmp(arg, "off") == 0) ? NULL : arg);
+	}
+
+	if (pg->n_stages == PIPE_MAX_STAGES) {
+		printf("Error: pipe_add_stage too many stages!\n");
+		return -1;
+	}
+	pipe_stage * st = &pg->stage[pg->n_stages];
+	memset(st, 0, sizeof(pipe_stage));
+	st->fs = pipe_rate(pg);
+	st->per_sample = 1;
+
+	if (strcmp(name, "hampel") == 0 || strcmp(name, "median") == 0) {
+		n = sscanf(line, "%*s %lf %lf", &a[0], &a[1]);
+		if (n < 1)
+			goto bad;
+		st->kind = (name[0] == 'h') ? PIPE_HAMPEL : PIPE_MEDIAN;
+		st->state = calloc(1, sizeof(med_filt));
+		if (st->state == NULL
+				|| med_init((med_filt *) st->state, (int) a[0],
+						(n > 1) ? a[1] : 3.0) == -1)
+			goto fail;
+	} else if (strcmp(name, "fir") == 0) {
+		if (sscanf(line, "%*s %lf %lf %lf %lf %lf", &a[0], &a[1], &a[2], &a[3],
+				&a[4]) != 5)
+			goto bad;
+		st->kind = PIPE_FIR;
+		st->state = calloc(1, sizeof(tune_filt));
+		if (st->state == NULL || pipe_fir_init(pg, st, a) == -1)
+			goto fail;
+	} else if (strcmp(name, "anc") == 0) {
+		n = sscanf(line, "%*s %31s %lf %lf %lf %lf", arg, &a[0], &a[1], &a[2],
+				&a[3]);
+		// the pipeline has no separate reference column, ANC_EXTERNAL is out
+		if (n < 4 || (strcmp(arg, "nlms") != 0 && strcmp(arg, "rls") != 0)
+				|| a[0] < 0)
+			goto bad;
+		st->kind = PIPE_ANC;
+		st->state = calloc(1, sizeof(anc_filt));
+		if (st->state == NULL
+				|| anc_init((anc_filt *) st->state,
+						(arg[0] == 'n') ? ANC_NLMS : ANC_RLS, (int) a[1], (int) a[0],
+						(n > 4) ? (int) a[3] : 1, a[2]) == -1)
+			goto fail;
+	} else if (strcmp(name, "cic") == 0) {
+		n = sscanf(line, "%*s %lf %lf %lf %lf %lf %lf %lf %lf", &a[0], &a[1],
+				&a[2], &a[3], &a[4], &a[5], &a[6], &a[7]);
+		if (n != 5 && n != 8)
+			goto bad;
+		st->kind = PIPE_CIC;
+		st->state = calloc(1, sizeof(cic_filt));
+		if (st->state == NULL
+				|| cic_init((cic_filt *) st->state, (int) a[0], (int) a[1],
+						(int) a[2], a[3], a[4]) == -1)
+			goto fail;
+		if (n == 8
+				&& cic_comp_design((cic_filt *) st->state, (int) a[5], a[6],
+						(int) a[7]) == -1)
+			goto fail;
+	} else if (strcmp(name, "event") == 0) {
+		n = sscanf(line, "%*s %31s %lf %lf %lf %255s", name, &a[0], &a[1], &a[2],
+				arg);
+		if (n < 4 || (strcmp(name, "deriv") != 0 && strcmp(name, "cusum") != 0))
+			goto bad;
+		st->kind = PIPE_EVENT;
+		pipe_events * pe = (pipe_events *) calloc(1, sizeof(pipe_events));
+		st->state = pe;
+		// at most one event per channel per sample
+		if (pe == NULL
+				|| (pe->ev = (ev_event *) malloc(
+						sizeof(ev_event) * OUT_NUM * pg->block_len)) == NULL
+				|| ev_init(&pe->det, (name[0] == 'd') ? EV_DERIV : EV_CUSUM, st->fs,
+						a[0], a[1], (int) a[2]) == -1)
+			goto fail;
+		if (n == 5 && (st->fp = fopen(arg, "w")) == NULL )
+			goto fail;
+	} else if (strcmp(name, "spectrum") == 0) {
+		n = sscanf(line, "%*s %lf %lf %255s", &a[0], &a[1], arg);
+		if (n < 2 || a[0] < 2 || a[1] < 1 || a[1] > a[0])
+			goto bad;
+		st->kind = PIPE_SPECTRUM;
+		st->per_sample = 0;
+		st->state = calloc(1, sizeof(pipe_spec));
+		if (st->state == NULL
+				|| pipe_spec_init((pipe_spec *) st->state, (int) a[0],
+						(int) a[1]) == -1)
+			goto fail;
+		// one spectrum per slot, [bin][channel]
+		if (n == 3
+				&& shm_pub_open(&((pipe_spec *) st->state)->shm, arg,
+						PIPE_SHM_SLOTS, ((int) a[0] / 2 + 1) * OUT_NUM) == -1)
+			goto fail;
+	} else if (strcmp(name, "sink") == 0) {
+		if (sscanf(line, "%*s %31s", name) != 1)
+			goto bad;
+		st->kind = PIPE_SINK;
+		st->per_sample = 0;
+		if (strcmp(name, "file") == 0) {
+			if (sscanf(line, "%*s %*s %255s", arg) != 1)
+				goto bad;
+			st->fp = fopen(arg, "w");
+			if (st->fp == NULL )
+				goto fail;
+		} else if (strcmp(name, "shm") == 0) {
+			if (sscanf(line, "%*s %*s %255s", arg) != 1)
+				goto bad;
+			// one block of samples per slot
+			st->state = calloc(1, sizeof(shm_pub));
+			if (st->state == NULL
+					|| shm_pub_open((shm_pub *) st->state, arg, PIPE_SHM_SLOTS,
+							pg->block_len * OUT_NUM) == -1)
+				goto fail;
+		} else if (strcmp(name, "callback") != 0) {
+			goto bad;
+		}
+	} else {
+		goto bad;
+	}
+
+	pg->n_stages++;
+	return 0;
+
+bad:
+	printf("Error: pipe_add_stage could not parse \"%s\"!\n", line);
+	return -1;
+
+fail:
+	// count the stage so pipe_free releases whatever was set up
+	printf("Error: pipe_add_stage failed to set up \"%s\"!\n", name);
+	pg->n_stages++;
+	return -1;
+} /* int pipe_add_stage */
+
+/*
+ * function: pipe_load
+ * purpose: builds a pipeline from a config file
+ * inputs: - pipe_graph * PG
+ * 		   - char * PATH
+ * 		   - double FS (default sample rate, overridden by a "rate" line)
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_load(pipe_graph * pg, char * path, double fs) {
+	char line[PIPE_LINE_LEN];
+	FILE * fp = fopen(path, "r");
+	if (fp == NULL ) {
+		printf("Error: pipe_load could not open %s!\n", path);
+		return -1;
+	}
+	if (pipe_init(pg, fs, 256) == -1) {
+		fclose(fp);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), fp) != NULL ) {
+		line[strcspn(line, "\r\n")] = '\0';
+		if (pipe_add_stage(pg, line) == -1) {
+			fclose(fp);
+			return -1;
+		}
+	}
+	fclose(fp);
+	return 0;
+} /* int pipe_load */
+
+/*
+ * function: pipe_free
+ * purpose: releases every stage and block buffer held by the pipeline
+ * inputs: - pipe_graph * PG
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_free(pipe_graph * pg) {
+	if (pg == NULL )
+		return -1;
+	int s;
+	for (s = 0; s < pg->n_stages; s++) {
+		pipe_stage * st = &pg->stage[s];
+		if (st->state != NULL ) {
+			if (st->kind == PIPE_HAMPEL || st->kind == PIPE_MEDIAN)
+				med_free((med_filt *) st->state);
+			else if (st->kind == PIPE_FIR)
+				tune_free((tune_filt *) st->state);
+			else if (st->kind == PIPE_ANC)
+				anc_free((anc_filt *) st->state);
+			else if (st->kind == PIPE_CIC)
+				cic_free((cic_filt *) st->state);
+			else if (st->kind == PIPE_EVENT) {
+				ev_free(&((pipe_events *) st->state)->det);
+				free(((pipe_events *) st->state)->ev);
+			}
+			else if (st->kind == PIPE_SPECTRUM)
+				pipe_spec_free((pipe_spec *) st->state);
+			else if (st->kind == PIPE_SINK)
+				shm_pub_close((shm_pub *) st->state);
+			free(st->state);
+		}
+		if (st->fp != NULL )
+			fclose(st->fp);
+	}
+	free(pg->buf[0]);
+	free(pg->buf[1]);
+	memset(pg, 0, sizeof(pipe_graph));
+	return 0;
+} /* int pipe_free */
+
+// runs one per-sample stage in place. returns 1 if X continues down the run
+static int pipe_sample(pipe_stage * st, sig_type x) {
+	switch (st->kind) {
+	case PIPE_HAMPEL:
+		return (hampel_process((med_filt *) st->state, x, x) == 0) ? 1 : -1;
+	case PIPE_MEDIAN:
+		return (median_process((med_filt *) st->state, x, x) == 0) ? 1 : -1;
+	case PIPE_FIR:
+		return (tune_process((tune_filt *) st->state, x, x) == 0) ? 1 : -1;
+	case PIPE_ANC:
+		return (anc_process((anc_filt *) st->state, x, 0.0, x) == 0) ? 1 : -1;
+	case PIPE_CIC:
+		return cic_process((cic_filt *) st->state, x, x);
+	case PIPE_EVENT: {
+		pipe_events * pe = (pipe_events *) st->state;
+		int r = ev_process(&pe->det, x, pe->ev + pe->n_ev);
+		if (r == -1)
+			return -1;
+		pe->n_ev += r;
+		return 1;
+	}
+	default:
+		return -1;
+	}
+}
+
+// hands the events collected by stage S over the last block on
+static int pipe_event_flush(pipe_graph * pg, int s, pipe_stage * st) {
+	pipe_events * pe = (pipe_events *) st->state;
+	if (pe->n_ev == 0)
+		return 0;
+	if (pg->ev_cb != NULL )
+		pg->ev_cb(pg->ev_ctx, s, pe->ev, pe->n_ev);
+	int k;
+	for (k = 0; k < pe->n_ev && st->fp != NULL; k++) {
+		ev_event * e = &pe->ev[k];
+		fprintf(st->fp, "%.9f %ld %d %d %.9g\n", e->time, (long) e->index, e->ch,
+				e->dir, e->mag);
+	}
+	pe->n_ev = 0;
+	return 0;
+}
+
+static int pipe_spec_block(pipe_graph * pg, int s, pipe_spec * ps,
+		sig_type * in, int len) {
+	int n, j, k;
+	int half = ps->fft_len / 2 + 1;
+	for (n = 0; n < len; n++) {
+		for (j = 0; j < OUT_NUM; j++)
+			ps->frame[j][ps->fill] = in[n][j];
+		if (++ps->fill < ps->fft_len)
+			continue;
+
+		for (j = 0; j < OUT_NUM; j++) {
+			memcpy(ps->scratch, ps->frame[j], sizeof(double) * ps->fft_len);
+			fftw_execute_dft_r2c(ps->plan, ps->scratch, ps->out);
+			for (k = 0; k < half; k++)
+				ps->pb[k][j] = sqrt(ps->out[k][0] * ps->out[k][0]
+						+ ps->out[k][1] * ps->out[k][1]);
+			memmove(ps->frame[j], ps->frame[j] + ps->hop,
+					sizeof(double) * (ps->fft_len - ps->hop));
+		}
+		ps->fill = ps->fft_len - ps->hop;
+		if (pg->cb != NULL )
+			pg->cb(pg->cb_ctx, s, PIPE_SPECTRUM, ps->pb, half);
+		if (ps->shm.hdr != NULL
+				&& shm_publish(&ps->shm, SHM_SPECTRUM, (double *) ps->pb,
+						half * OUT_NUM) == -1)
+			return -1;
+	}
+	return 0;
+}
+
+static int pipe_sink_block(pipe_graph * pg, int s, pipe_stage * st,
+		sig_type * in, int len) {
+	if (st->state != NULL )
+		return shm_publish((shm_pub *) st->state, SHM_SAMPLES, (double *) in,
+				len * OUT_NUM);
+	if (st->fp == NULL ) {
+		if (pg->cb != NULL )
+			pg->cb(pg->cb_ctx, s, PIPE_SINK, in, len);
+		return 0;
+	}
+	int n, j;
+	for (n = 0; n < len; n++) {
+		for (j = 0; j < OUT_NUM; j++)
+			fprintf(st->fp, (j + 1 < OUT_NUM) ? "%.9g " : "%.9g\n", in[n][j]);
+	}
+	return 0;
+}
+
+/*
+ * function: pipe_run
+ * purpose: pushes LEN samples through the pipeline, BLOCK_LEN at a time.
+ * 			fused per-sample runs write into internal ping-pong buffers; the
+ * 			output of the final stage for the last block is returned in OUT.
+ * inputs: - pipe_graph * PG
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * 		   - sig_type ** OUT (may be NULL)
+ * 		   - int * OUT_LEN (may be NULL)
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_run(pipe_graph * pg, sig_type * in, int len, sig_type ** out,
+		int * out_len) {
+	if (pg == NULL || in == NULL )
+		return -1;
+	if (pg->buf[0] == NULL ) {
+		pg->buf[0] = (sig_type *) malloc(sizeof(sig_type) * pg->block_len);
+		pg->buf[1] = (sig_type *) malloc(sizeof(sig_type) * pg->block_len);
+		if (pg->buf[0] == NULL || pg->buf[1] == NULL ) {
+			printf("Error: pipe_run failed mem allocation!\n");
+			return -1;
+		}
+	}
+
+	sig_type * cur = in;
+	int cur_len = 0;
+	int b;
+	for (b = 0; b < len; b += pg->block_len) {
+		cur = in + b;
+		cur_len = (len - b < pg->block_len) ? len - b : pg->block_len;
+		int which = 0;
+		int s = 0;
+		while (s < pg->n_stages) {
+			if (pg->stage[s].kind == PIPE_FIR && !pg->stage[s].per_sample) {
+				// FFT convolution, the whole block at once
+				sig_type * dst = pg->buf[which];
+				if (tune_block((tune_filt *) pg->stage[s].state, cur, dst, cur_len)
+						== -1)
+					return -1;
+				cur = dst;
+				which ^= 1;
+				s++;
+				continue;
+			}
+			if (!pg->stage[s].per_sample) {
+				int err = (pg->stage[s].kind == PIPE_SPECTRUM) ?
+						pipe_spec_block(pg, s, (pipe_spec *) pg->stage[s].state, cur,
+								cur_len) :
+						pipe_sink_block(pg, s, &pg->stage[s], cur, cur_len);
+				if (err == -1)
+					return -1;
+				s++;
+				continue;
+			}
+
+			// fused run of per-sample stages [s, e)
+			int e = s;
+			while (e < pg->n_stages && pg->stage[e].per_sample)
+				e++;
+			sig_type * dst = pg->buf[which];
+			int n, k, m = 0;
+			for (n = 0; n < cur_len; n++) {
+				sig_type x;
+				memcpy(x, cur[n], sizeof(sig_type));
+				int r = 1;
+				for (k = s; k < e && r == 1; k++)
+					r = pipe_sample(&pg->stage[k], x);
+				if (r == -1)
+					return -1;
+				if (r == 1)
+					memcpy(dst[m++], x, sizeof(sig_type));
+			}
+			for (k = s; k < e; k++)
+				if (pg->stage[k].kind == PIPE_EVENT)
+					pipe_event_flush(pg, k, &pg->stage[k]);
+			cur = dst;
+			cur_len = m;
+			which ^= 1;
+			s = e;
+		}
+	}
+	if (out != NULL )
+		*out = cur;
+	if (out_len != NULL )
+		*out_len = cur_len;
+	return 0;
+} /* int pipe_run */
@@ -0,0 +1,161 @@
+/*
+ * pipe_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef PIPE_HELPER_H_
+#define PIPE_HELPER_H_
+
+#include "median_helper.h"
+#include "cic_helper.h"
+#include "fir_helper.h"
+#include "anc_helper.h"
+#include "shm_helper.h"
+#include "plan_helper.h"
+#include "event_helper.h"
+#include "tune_helper.h"
+
+#define PIPE_MAX_STAGES 16
+#define PIPE_LINE_LEN 256
+#define PIPE_SHM_SLOTS 256
+
+// stage kinds
+#define PIPE_HAMPEL 0
+#define PIPE_MEDIAN 1
+#define PIPE_FIR 2
+#define PIPE_CIC 3
+#define PIPE_SPECTRUM 4
+#define PIPE_SINK 5
+#define PIPE_ANC 6
+#define PIPE_EVENT 7
+
+// callback for block stages: spectra (LEN = fft_len / 2 + 1 bins) and sink samples
+typedef void (*pipe_cb)(void * ctx, int stage, int kind, sig_type * data, int len);
+// callback for the events an event stage found in one block
+typedef void (*pipe_ev_cb)(void * ctx, int stage, ev_event * ev, int n_ev);
+
+// sliding spectrum state, one cached FFTW plan reused for every channel
+typedef struct {
+	int fft_len;
+	int hop;
+	int fill;
+	double * frame[OUT_NUM];
+	double * scratch;
+	fftw_complex * out;
+	fftw_plan plan;
+	sig_type * pb;
+	// optional shm ring for the spectra, unused while SHM.HDR is NULL
+	shm_pub shm;
+} pipe_spec;
+
+// event stage, events collect over a block and are handed on after it
+typedef struct {
+	ev_det det;
+	int n_ev;
+	ev_event * ev;
+} pipe_events;
+
+typedef struct {
+	int kind;
+	int per_sample;
+	double fs;
+	void * state;
+	FILE * fp;
+} pipe_stage;
+
+typedef struct {
+	double fs;
+	int block_len;
+	int n_stages;
+	pipe_stage stage[PIPE_MAX_STAGES];
+	sig_type * buf[2];
+	pipe_cb cb;
+	void * cb_ctx;
+	pipe_ev_cb ev_cb;
+	void * ev_ctx;
+	// tune_select cache prefix for FIR stages, empty: no tuning
+	char tune[PIPE_LINE_LEN];
+} pipe_graph;
+
+/*
+ * function: pipe_init
+ * purpose: initializes an empty pipeline
+ * inputs: - pipe_graph * PG
+ * 		   - double FS
+ * 		   - int BLOCK_LEN
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_init(pipe_graph * pg, double fs, int block_len);
+
+/*
+ * function: pipe_set_tune
+ * purpose: sets the tune_select cache prefix for FIR stages added later
+ * inputs: - pipe_graph * PG
+ * 		   - char * PREFIX (NULL or "": no tuning)
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_set_tune(pipe_graph * pg, char * prefix);
+
+/*
+ * function: pipe_set_callback
+ * purpose: sets the function that receives spectra and "sink callback" output
+ * inputs: - pipe_graph * PG
+ * 		   - pipe_cb CB
+ * 		   - void * CTX
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_set_callback(pipe_graph * pg, pipe_cb cb, void * ctx);
+
+/*
+ * function: pipe_set_event_callback
+ * purpose: sets the function that receives the events of event stages
+ * inputs: - pipe_graph * PG
+ * 		   - pipe_ev_cb CB
+ * 		   - void * CTX
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_set_event_callback(pipe_graph * pg, pipe_ev_cb cb, void * ctx);
+
+/*
+ * function: pipe_add_stage
+ * purpose: parses one config line and appends the stage it describes
+ * inputs: - pipe_graph * PG
+ * 		   - char * LINE
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_add_stage(pipe_graph * pg, char * line);
+
+/*
+ * function: pipe_load
+ * purpose: builds a pipeline from a config file (see pipeline.cfg)
+ * inputs: - pipe_graph * PG
+ * 		   - char * PATH
+ * 		   - double FS
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_load(pipe_graph * pg, char * path, double fs);
+
+/*
+ * function: pipe_free
+ * purpose: releases every stage and block buffer held by the pipeline
+ * inputs: - pipe_graph * PG
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_free(pipe_graph * pg);
+
+/*
+ * function: pipe_run
+ * purpose: pushes LEN samples through the pipeline, BLOCK_LEN at a time,
+ * 			fusing adjacent per-sample stages into one pass per block
+ * inputs: - pipe_graph * PG
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * 		   - sig_type ** OUT (may be NULL)
+ * 		   - int * OUT_LEN (may be NULL)
+ * returns: 0 - success, -1 - failure
+ */
+int pipe_run(pipe_graph * pg, sig_type * in, int len, sig_type ** out,
+		int * out_len);
+
+#endif /* PIPE_HELPER_H_ */
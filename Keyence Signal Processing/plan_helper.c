@@ -0,0 +1,258 @@
+/*
+ * plan_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: process wide FFTW plan cache. Plans are keyed by (size, type,
+ *      		 stride, batch) and made once, on scratch arrays, then shared by
+ *      		 every user through FFTW's new-array execute functions
+ *      		 (fftw_execute_dft_r2c / _c2r). Arrays passed to those must come
+ *      		 from fftw_malloc so their alignment matches the planning arrays.
+ *      		 The FFTW planner is not thread safe, so lookups and planning
+ *      		 are serialised by one mutex; executing a plan needs no lock.
+ *
+ *      		 Layout for a key:
+ *      		   STRIDE 1: BATCH transforms stored one after another
+ *      		             (distance N reals / N / 2 + 1 complex)
+ *      		   STRIDE S: BATCH <= S transforms interleaved, element i of
+ *      		             transform b at i * S + b; a sig_type array is
+ *      		             STRIDE = BATCH = OUT_NUM
+ *
+ *      		 Sizes need not be powers of two. spec_init builds a runtime
+ *      		 sized, zero padded magnitude spectrum on top of the cache.
+ */
+
+#include "plan_helper.h"
+
+// the one process wide cache, declared in plan_helper.h
+pthread_mutex_t plan_lock = PTHREAD_MUTEX_INITIALIZER;
+plan_entry plan_cache[PLAN_CACHE_MAX];
+int plan_count;
+long plan_hits;
+long plan_misses;
+unsigned plan_flags = FFTW_MEASURE;
+
+// plans KEY on scratch arrays sized for its layout
+static fftw_plan plan_make(int n, int type, int stride, int batch) {
+	int bins = n / 2 + 1;
+	size_t n_real = (stride == 1) ? (size_t) n * batch : (size_t) n * stride;
+	size_t n_cplx = (stride == 1) ? (size_t) bins * batch : (size_t) bins * stride;
+	int rdist = (stride == 1) ? n : 1;
+	int cdist = (stride == 1) ? bins : 1;
+
+	double * r = (double *) fftw_malloc(sizeof(double) * n_real);
+	fftw_complex * c = (fftw_complex *) fftw_malloc(sizeof(fftw_complex) * n_cplx);
+	fftw_plan plan = NULL;
+	if (r != NULL && c != NULL ) {
+		if (type == PLAN_R2C)
+			plan = fftw_plan_many_dft_r2c(1, &n, batch, r, NULL, stride, rdist, c,
+					NULL, stride, cdist, plan_flags);
+		else
+			plan = fftw_plan_many_dft_c2r(1, &n, batch, c, NULL, stride, cdist, r,
+					NULL, stride, rdist, plan_flags);
+	}
+	fftw_free(r);
+	fftw_free(c);
+	return plan;
+}
+
+/*
+ * function: plan_get
+ * purpose: returns the shared plan for a transform, planning it on first use.
+ * 			The plan belongs to the cache: execute it with the new-array
+ * 			functions and never destroy it.
+ * inputs: - int N (transform length)
+ * 		   - int TYPE (PLAN_R2C, PLAN_C2R)
+ * 		   - int STRIDE
+ * 		   - int BATCH (<= STRIDE when STRIDE > 1)
+ * returns: plan, NULL - failure
+ */
+fftw_plan plan_get(int n, int type, int stride, int batch) {
+	if (n < 1 || (type != PLAN_R2C && type != PLAN_C2R) || stride < 1
+			|| batch < 1 || (stride > 1 && batch > stride)) {
+		printf("Error: plan_get invalid parameters!\n");
+		return NULL ;
+	}
+
+	pthread_mutex_lock(&plan_lock);
+	fftw_plan plan = NULL;
+	int i;
+	for (i = 0; i < plan_count; i++) {
+		plan_entry * e = &plan_cache[i];
+		if (e->n == n && e->type == type && e->stride == stride
+				&& e->batch == batch) {
+			plan = e->plan;
+			plan_hits++;
+			break;
+		}
+	}
+	if (plan == NULL ) {
+		plan_misses++;
+		if (plan_count == PLAN_CACHE_MAX) {
+			printf("Error: plan_get cache full!\n");
+		} else if ((plan = plan_make(n, type, stride, batch)) == NULL ) {
+			printf("ERROR: plan_get failed to generate plan for fftw!\n");
+		} else {
+			plan_entry * e = &plan_cache[plan_count++];
+			e->n = n;
+			e->type = type;
+			e->stride = stride;
+			e->batch = batch;
+			e->plan = plan;
+		}
+	}
+	pthread_mutex_unlock(&plan_lock);
+	return plan;
+} /* fftw_plan plan_get */
+
+/*
+ * function: plan_set_flags
+ * purpose: planner rigor for plans made from now on (FFTW_ESTIMATE,
+ * 			FFTW_MEASURE (default), FFTW_PATIENT, FFTW_EXHAUSTIVE)
+ * inputs: - unsigned FLAGS
+ * returns: 0 - success, -1 - failure
+ */
+int plan_set_flags(unsigned flags) {
+	pthread_mutex_lock(&plan_lock);
+	plan_flags = flags;
+	pthread_mutex_unlock(&plan_lock);
+	return 0;
+} /* int plan_set_flags */
+
+/*
+ * function: plan_stats
+ * purpose: reports cache lookups served from the cache and those that planned
+ * inputs: - long * HITS
+ * 		   - long * MISSES
+ * 		   - int * N_PLANS (may be NULL)
+ * returns: 0 - success, -1 - failure
+ */
+int plan_stats(long * hits, long * misses, int * n_plans) {
+	if (hits == NULL || misses == NULL )
+		return -1;
+	pthread_mutex_lock(&plan_lock);
+	*hits = plan_hits;
+	*misses = plan_misses;
+	if (n_plans != NULL )
+		*n_plans = plan_count;
+	pthread_mutex_unlock(&plan_lock);
+	return 0;
+} /* int plan_stats */
+
+/*
+ * function: plan_clear
+ * purpose: destroys every cached plan and resets the statistics. No plan from
+ * 			plan_get may be in use.
+ * returns: 0 - success, -1 - failure
+ */
+int plan_clear(void) {
+	pthread_mutex_lock(&plan_lock);
+	int i;
+	for (i = 0; i < plan_count; i++)
+		fftw_destroy_plan(plan_cache[i].plan);
+	plan_count = 0;
+	plan_hits = 0;
+	plan_misses = 0;
+	pthread_mutex_unlock(&plan_lock);
+	return 0;
+} /* int plan_clear */
+
+/*
+ * function: plan_wisdom_load
+ * purpose: imports FFTW wisdom saved by plan_wisdom_save, so plans made
+ * 			afterwards skip the measurements already done on this machine
+ * inputs: - char * PATH
+ * returns: 0 - success, -1 - failure (e.g. no wisdom saved yet)
+ */
+int plan_wisdom_load(char * path) {
+	pthread_mutex_lock(&plan_lock);
+	int ok = fftw_import_wisdom_from_filename(path);
+	pthread_mutex_unlock(&plan_lock);
+	return ok ? 0 : -1;
+} /* int plan_wisdom_load */
+
+/*
+ * function: plan_wisdom_save
+ * purpose: exports the wisdom of every plan made so far
+ * inputs: - char * PATH
+ * returns: 0 - success, -1 - failure
+ */
+int plan_wisdom_save(char * path) {
+	pthread_mutex_lock(&plan_lock);
+	int ok = fftw_export_wisdom_to_filename(path);
+	pthread_mutex_unlock(&plan_lock);
+	if (!ok) {
+		printf("Error: plan_wisdom_save could not write %s!\n", path);
+		return -1;
+	}
+	return 0;
+} /* int plan_wisdom_save */
+
+/*
+ * function: spec_init
+ * purpose: prepares a magnitude spectrum of DATA_LEN samples zero padded to
+ * 			FFT_LEN (any length, not only powers of two)
+ * inputs: - spec_plan * SP
+ * 		   - int FFT_LEN
+ * 		   - int DATA_LEN (1 .. FFT_LEN)
+ * returns: 0 - success, -1 - failure
+ */
+int spec_init(spec_plan * sp, int fft_len, int data_len) {
+	if (sp == NULL || fft_len < 2 || data_len < 1 || data_len > fft_len) {
+		printf("Error: spec_init invalid parameters!\n");
+		return -1;
+	}
+	memset(sp, 0, sizeof(spec_plan));
+	sp->fft_len = fft_len;
+	sp->data_len = data_len;
+	sp->n_bins = fft_len / 2 + 1;
+	sp->in = (double *) fftw_malloc(sizeof(sig_type) * fft_len);
+	sp->out = (fftw_complex *) fftw_malloc(
+			sizeof(fftw_complex) * sp->n_bins * OUT_NUM);
+	if (sp->in == NULL || sp->out == NULL ) {
+		printf("Error: spec_init failed mem allocation!\n");
+		return -1;
+	}
+	// the padding is written once, spec_mag only refills the data
+	memset(sp->in, 0, sizeof(sig_type) * fft_len);
+	sp->plan = plan_get(fft_len, PLAN_R2C, OUT_NUM, OUT_NUM);
+	return (sp->plan == NULL ) ? -1 : 0;
+} /* int spec_init */
+
+/*
+ * function: spec_free
+ * purpose: releases the buffers of a spec_plan (the plan stays cached)
+ * inputs: - spec_plan * SP
+ * returns: 0 - success, -1 - failure
+ */
+int spec_free(spec_plan * sp) {
+	if (sp == NULL )
+		return -1;
+	fftw_free(sp->in);
+	fftw_free(sp->out);
+	memset(sp, 0, sizeof(spec_plan));
+	return 0;
+} /* int spec_free */
+
+/*
+ * function: spec_mag
+ * purpose: magnitude spectrum of DATA_LEN samples of X, N_BINS bins per channel
+ * inputs: - spec_plan * SP
+ * 		   - sig_type * X
+ * 		   - sig_type * MAG (N_BINS entries)
+ * returns: 0 - success, -1 - failure
+ */
+int spec_mag(spec_plan * sp, sig_type * x, sig_type * mag) {
+	if (sp == NULL || sp->plan == NULL || x == NULL || mag == NULL )
+		return -1;
+	memcpy(sp->in, x, sizeof(sig_type) * sp->data_len);
+	fftw_execute_dft_r2c(sp->plan, sp->in, sp->out);
+	int k, j;
+	for (k = 0; k < sp->n_bins; k++) {
+		for (j = 0; j < OUT_NUM; j++) {
+			double * c = sp->out[k * OUT_NUM + j];
+			mag[k][j] = sqrt(c[0] * c[0] + c[1] * c[1]);
+		}
+	}
+	return 0;
+} /* int spec_mag */
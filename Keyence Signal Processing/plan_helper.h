@@ -0,0 +1,126 @@
+/*
+ * plan_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef PLAN_HELPER_H_
+#define PLAN_HELPER_H_
+
+#include <pthread.h>
+#include "sig_support.c"
+
+#define PLAN_CACHE_MAX 64
+
+// transform types
+#define PLAN_R2C 0
+#define PLAN_C2R 1
+
+typedef struct {
+	int n;
+	int type;
+	int stride;
+	int batch;
+	fftw_plan plan;
+} plan_entry;
+
+// cache state, defined once in plan_helper.c. plan_lock also serialises every
+// FFTW planner and wisdom call in the process
+extern pthread_mutex_t plan_lock;
+extern plan_entry plan_cache[PLAN_CACHE_MAX];
+extern int plan_count;
+extern long plan_hits;
+extern long plan_misses;
+extern unsigned plan_flags;
+
+// runtime sized magnitude spectrum of all channels with one interleaved plan
+typedef struct {
+	int fft_len;
+	int data_len;
+	int n_bins;
+	double * in;
+	fftw_complex * out;
+	fftw_plan plan;
+} spec_plan;
+
+/*
+ * function: plan_get
+ * purpose: returns the shared plan for a transform, planning it on first use
+ * inputs: - int N
+ * 		   - int TYPE (PLAN_R2C, PLAN_C2R)
+ * 		   - int STRIDE
+ * 		   - int BATCH
+ * returns: plan, NULL - failure
+ */
+fftw_plan plan_get(int n, int type, int stride, int batch);
+
+/*
+ * function: plan_set_flags
+ * purpose: planner rigor for plans made from now on
+ * inputs: - unsigned FLAGS
+ * returns: 0 - success, -1 - failure
+ */
+int plan_set_flags(unsigned flags);
+
+/*
+ * function: plan_stats
+ * purpose: reports cache hits, misses and the number of plans held
+ * inputs: - long * HITS
+ * 		   - long * MISSES
+ * 		   - int * N_PLANS
+ * returns: 0 - success, -1 - failure
+ */
+int plan_stats(long * hits, long * misses, int * n_plans);
+
+/*
+ * function: plan_clear
+ * purpose: destroys every cached plan
+ * returns: 0 - success, -1 - failure
+ */
+int plan_clear(void);
+
+/*
+ * function: plan_wisdom_load
+ * purpose: imports FFTW wisdom saved by plan_wisdom_save
+ * inputs: - char * PATH
+ * returns: 0 - success, -1 - failure
+ */
+int plan_wisdom_load(char * path);
+
+/*
+ * function: plan_wisdom_save
+ * purpose: exports the wisdom of every plan made so far
+ * inputs: - char * PATH
+ * returns: 0 - success, -1 - failure
+ */
+int plan_wisdom_save(char * path);
+
+/*
+ * function: spec_init
+ * purpose: prepares a zero padded magnitude spectrum of any length
+ * inputs: - spec_plan * SP
+ * 		   - int FFT_LEN
+ * 		   - int DATA_LEN
+ * returns: 0 - success, -1 - failure
+ */
+int spec_init(spec_plan * sp, int fft_len, int data_len);
+
+/*
+ * function: spec_free
+ * purpose: releases the buffers of a spec_plan
+ * inputs: - spec_plan * SP
+ * returns: 0 - success, -1 - failure
+ */
+int spec_free(spec_plan * sp);
+
+/*
+ * function: spec_mag
+ * purpose: magnitude spectrum of DATA_LEN samples of X
+ * inputs: - spec_plan * SP
+ * 		   - sig_type * X
+ * 		   - sig_type * MAG
+ * returns: 0 - success, -1 - failure
+ */
+int spec_mag(spec_plan * sp, sig_type * x, sig_type * mag);
+
+#endif /* PLAN_HELPER_H_ */
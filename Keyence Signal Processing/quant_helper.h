@@ -0,0 +1,115 @@
+/*
+ * quant_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef QUANT_HELPER_H_
+#define QUANT_HELPER_H_
+
+#include "sig_support.c"
+
+#define QS_DEFAULT_COMPRESSION 100
+// raw sample buffer, in multiples of the centroid capacity
+#define QS_BUF_FACTOR 4
+// flush work units (one heap sift or one merged value) per sample and channel,
+// enough to fold a full buffer before the next one fills
+#define QS_STEPS 4
+
+// incremental flush phases
+#define QS_IDLE 0
+#define QS_HEAPIFY 1
+#define QS_EXTRACT 2
+#define QS_MERGE 3
+
+typedef struct {
+	double mean;
+	double weight;
+} qs_centroid;
+
+typedef struct {
+	int cap;
+	int n_cent;
+	qs_centroid * cent;
+	int buf_cap;
+	int n_buf;
+	double * buf;
+	qs_centroid * scratch;
+	// full buffer being folded in by qs_add, a few steps per sample
+	double * work;
+	int n_work;
+	int phase;
+	int i;
+	int a;
+	int b;
+	// greedy compression of the merged run into SCRATCH
+	int n_out;
+	double w_all;
+	double w_done;
+	double w_lim;
+	double sum;
+	double w;
+	double total;
+	double min;
+	double max;
+} qs_digest;
+
+typedef struct {
+	double compression;
+	qs_digest d[OUT_NUM];
+} qs_sketch;
+
+/*
+ * function: qs_init
+ * purpose: allocates an empty per channel quantile sketch
+ * inputs: - qs_sketch * QS
+ * 		   - double COMPRESSION (>= 10)
+ * returns: 0 - success, -1 - failure
+ */
+int qs_init(qs_sketch * qs, double compression);
+
+/*
+ * function: qs_free
+ * purpose: releases memory held by a qs_sketch
+ * inputs: - qs_sketch * QS
+ * returns: 0 - success, -1 - failure
+ */
+int qs_free(qs_sketch * qs);
+
+/*
+ * function: qs_reset
+ * purpose: empties the sketch, keeping its memory
+ * inputs: - qs_sketch * QS
+ * returns: 0 - success, -1 - failure
+ */
+int qs_reset(qs_sketch * qs);
+
+/*
+ * function: qs_add
+ * purpose: adds one sample per channel
+ * inputs: - qs_sketch * QS
+ * 		   - sig_type INPUT
+ * returns: 0 - success, -1 - failure
+ */
+int qs_add(qs_sketch * qs, sig_type input);
+
+/*
+ * function: qs_merge
+ * purpose: folds SRC into DST
+ * inputs: - qs_sketch * DST
+ * 		   - qs_sketch * SRC
+ * returns: 0 - success, -1 - failure
+ */
+int qs_merge(qs_sketch * dst, qs_sketch * src);
+
+/*
+ * function: qs_quantile
+ * purpose: estimates the Q quantile of channel CH
+ * inputs: - qs_sketch * QS
+ * 		   - int CH
+ * 		   - double Q
+ * returns: quantile estimate, NAN if the channel has no samples
+ */
+double qs_quantile(qs_sketch * qs, int ch, double q);
+
+#endif /* QUANT_HELPER_H_ */
@@ -0,0 +1,212 @@
+/*
+ * resamp_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: timestamp aware resampler. Takes (timestamp, sig_type) pairs with
+ *      		 acquisition jitter and dropped samples and produces samples on a
+ *      		 uniform FS_OUT clock, as assumed by the FIR and FFT code. Each
+ *      		 output falls between two input samples i and i + 1 at fraction
+ *      		 mu of their spacing; the 2 * K neighbours around it are weighted
+ *      		 by a precomputed polyphase table (cubic or windowed sinc) row
+ *      		 picked by mu. Weights are shared by all channels, so the inner
+ *      		 loop runs across OUT_NUM. The table assumes roughly even spacing,
+ *      		 so an output whose 2 * K input span holds two neighbours further
+ *      		 apart than MAX_GAP is not interpolated, it is set to NAN and
+ *      		 flagged.
+ */
+
+#include "resamp_helper.h"
+
+/*
+ * function: resamp_init
+ * purpose: builds the polyphase table and resets the resampler
+ * inputs: - resamp_state * RS
+ * 		   - int KERNEL (RESAMP_CUBIC, RESAMP_SINC)
+ * 		   - int HALF_WIDTH (taps either side for RESAMP_SINC, cubic uses 2)
+ * 		   - int N_PHASES
+ * 		   - double FS_OUT
+ * 		   - double MAX_GAP (seconds between inputs still interpolated across)
+ * returns: 0 - success, -1 - failure
+ */
+int resamp_init(resamp_state * rs, int kernel, int half_width, int n_phases,
+		double fs_out, double max_gap) {
+	if (rs == NULL || (kernel != RESAMP_CUBIC && kernel != RESAMP_SINC)
+			|| n_phases < 1 || fs_out <= 0.0 || max_gap <= 0.0
+			|| (kernel == RESAMP_SINC && half_width < 1)) {
+		printf("Error: resamp_init invalid parameters!\n");
+		return -1;
+	}
+	memset(rs, 0, sizeof(resamp_state));
+	rs->kernel = kernel;
+	rs->K = (kernel == RESAMP_CUBIC) ? 2 : half_width;
+	rs->n_phases = n_phases;
+	rs->fs_out = fs_out;
+	rs->max_gap = max_gap;
+
+	int W = 2 * rs->K;
+	rs->table = (double *) malloc(sizeof(double) * (n_phases + 1) * W);
+	rs->t_hist = (double *) malloc(sizeof(double) * W);
+	rs->x_hist = (sig_type *) malloc(sizeof(sig_type) * W);
+	if (rs->table == NULL || rs->t_hist == NULL || rs->x_hist == NULL ) {
+		printf("Error: resamp_init failed mem allocation!\n");
+		return -1;
+	}
+
+	int p, k;
+	for (p = 0; p <= n_phases; p++) {
+		double mu = (double) p / n_phases;
+		double * w = rs->table + p * W;
+		if (kernel == RESAMP_CUBIC) {
+			// Catmull-Rom weights for samples i - 1, i, i + 1, i + 2
+			double mu2 = mu * mu, mu3 = mu2 * mu;
+			w[0] = 0.5 * (-mu3 + 2.0 * mu2 - mu);
+			w[1] = 0.5 * (3.0 * mu3 - 5.0 * mu2 + 2.0);
+			w[2] = 0.5 * (-3.0 * mu3 + 4.0 * mu2 + mu);
+			w[3] = 0.5 * (mu3 - mu2);
+		} else {
+			// sinc tapered by a Blackman-Harris window spanning +-K samples
+			double sum = 0.0;
+			for (k = 0; k < W; k++) {
+				double d = (k - rs->K + 1) - mu;
+				double s = (fabs(d) < 1e-12) ? 1.0 : sin(pi * d) / (pi * d);
+				double u = d / rs->K;
+				double win = (fabs(u) >= 1.0) ? 0.0 :
+						0.35875 + 0.48829 * cos(pi * u) + 0.14128 * cos(2 * pi * u)
+								+ 0.01168 * cos(3 * pi * u);
+				w[k] = s * win;
+				sum += w[k];
+			}
+			// unity DC gain in every phase
+			for (k = 0; k < W; k++)
+				w[k] /= sum;
+		}
+	}
+	return 0;
+} /* int resamp_init */
+
+/*
+ * function: resamp_free
+ * purpose: releases memory held by a resamp_state
+ * inputs: - resamp_state * RS
+ * returns: 0 - success, -1 - failure
+ */
+int resamp_free(resamp_state * rs) {
+	if (rs == NULL )
+		return -1;
+	free(rs->table);
+	free(rs->t_hist);
+	free(rs->x_hist);
+	rs->table = NULL;
+	rs->t_hist = NULL;
+	rs->x_hist = NULL;
+	return 0;
+} /* int resamp_free */
+
+// number of outputs due before T1
+static int resamp_due(resamp_state * rs, double t1) {
+	int c = 0;
+	while (rs->t_start + (rs->n_out + c) / rs->fs_out < t1)
+		c++;
+	return c;
+}
+
+/*
+ * function: resamp_push
+ * purpose: feeds LEN timestamped samples and writes every uniform output that
+ * 			has become computable. Output lags input by K samples. Inputs with a
+ * 			timestamp not after the previous one are dropped and counted.
+ * 			Inputs are taken in order until the next one's outputs would not
+ * 			fit in CAP; RS->N_USED tells how many were taken, the rest can be
+ * 			pushed again once OUT has been drained.
+ * inputs: - resamp_state * RS
+ * 		   - double * T (seconds, increasing)
+ * 		   - sig_type * X
+ * 		   - int LEN
+ * 		   - double * T_OUT
+ * 		   - sig_type * OUT
+ * 		   - unsigned char * GAP (1: output inside an unfilled gap, value NAN)
+ * 		   - int CAP (room in T_OUT / OUT / GAP)
+ * returns: number of outputs written, -1 - failure (bad state, or CAP too
+ * 			small for the outputs of a single input; nothing is taken then)
+ */
+int resamp_push(resamp_state * rs, double * t, sig_type * x, int len,
+		double * t_out, sig_type * out, unsigned char * gap, int cap) {
+	if (rs == NULL || rs->table == NULL || t == NULL || x == NULL )
+		return -1;
+
+	int K = rs->K;
+	int W = 2 * K;
+	int m = 0;
+	int n, k, j;
+	rs->n_used = 0;
+	for (n = 0; n < len; n++, rs->n_used++) {
+		if (!rs->primed) {
+			// replicate the first sample backwards at the output period
+			for (k = 0; k < W; k++) {
+				rs->t_hist[k] = t[n] - (W - 1 - k) / rs->fs_out;
+				memcpy(rs->x_hist[k], x[n], sizeof(sig_type));
+			}
+			rs->t_start = t[n];
+			rs->t_next = t[n];
+			rs->primed = 1;
+			continue;
+		}
+		if (t[n] <= rs->t_hist[W - 1]) {
+			rs->n_dropped++;
+			continue;
+		}
+		// room check before any state changes, history sample K + 1 moves to K
+		int due = resamp_due(rs, (K + 1 < W) ? rs->t_hist[K + 1] : t[n]);
+		if (m + due > cap) {
+			if (m > 0)
+				break;
+			printf("Error: resamp_push output buffer too small!\n");
+			return -1;
+		}
+		memmove(rs->t_hist, rs->t_hist + 1, sizeof(double) * (W - 1));
+		memmove(rs->x_hist, rs->x_hist + 1, sizeof(sig_type) * (W - 1));
+		rs->t_hist[W - 1] = t[n];
+		memcpy(rs->x_hist[W - 1], x[n], sizeof(sig_type));
+
+		if (t[n] - rs->t_hist[W - 2] > rs->max_gap)
+			rs->n_gaps++;
+
+		// outputs bracketed by history samples K - 1 and K, weighted over all W
+		double t0 = rs->t_hist[K - 1];
+		double t1 = rs->t_hist[K];
+		int is_gap = 0;
+		for (k = 1; k < W; k++)
+			if (rs->t_hist[k] - rs->t_hist[k - 1] > rs->max_gap)
+				is_gap = 1;
+
+		while (rs->t_next < t1) {
+			if (t_out != NULL )
+				t_out[m] = rs->t_next;
+			if (is_gap) {
+				for (j = 0; j < OUT_NUM; j++)
+					out[m][j] = NAN;
+				rs->n_gap_out++;
+			} else {
+				double mu = (rs->t_next - t0) / (t1 - t0);
+				if (mu < 0.0)
+					mu = 0.0;
+				int p = (int) (mu * rs->n_phases + 0.5);
+				double * w = rs->table + p * W;
+				double acc[OUT_NUM] = { 0.0 };
+				for (k = 0; k < W; k++)
+					for (j = 0; j < OUT_NUM; j++)
+						acc[j] += w[k] * rs->x_hist[k][j];
+				for (j = 0; j < OUT_NUM; j++)
+					out[m][j] = acc[j];
+			}
+			if (gap != NULL )
+				gap[m] = (unsigned char) is_gap;
+			m++;
+			rs->n_out++;
+			// from the output count, so rounding never accumulates
+			rs->t_next = rs->t_start + rs->n_out / rs->fs_out;
+		}
+	}
+	return m;
+} /* int resamp_push */
@@ -0,0 +1,80 @@
+/*
+ * resamp_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef RESAMP_HELPER_H_
+#define RESAMP_HELPER_H_
+
+#include "sig_support.c"
+
+// interpolation kernels
+#define RESAMP_CUBIC 0
+#define RESAMP_SINC 1
+
+typedef struct {
+	int kernel;
+	int K;
+	int n_phases;
+	double fs_out;
+	double max_gap;
+	double * table;
+	// last 2K inputs, oldest first
+	double * t_hist;
+	sig_type * x_hist;
+	int primed;
+	double t_start;
+	double t_next;
+	// statistics
+	long n_out;
+	long n_gaps;
+	long n_gap_out;
+	long n_dropped;
+	// inputs taken by the last resamp_push
+	int n_used;
+} resamp_state;
+
+/*
+ * function: resamp_init
+ * purpose: builds the polyphase table and resets the resampler
+ * inputs: - resamp_state * RS
+ * 		   - int KERNEL (RESAMP_CUBIC, RESAMP_SINC)
+ * 		   - int HALF_WIDTH (taps either side for RESAMP_SINC)
+ * 		   - int N_PHASES
+ * 		   - double FS_OUT
+ * 		   - double MAX_GAP (seconds)
+ * returns: 0 - success, -1 - failure
+ */
+int resamp_init(resamp_state * rs, int kernel, int half_width, int n_phases,
+		double fs_out, double max_gap);
+
+/*
+ * function: resamp_free
+ * purpose: releases memory held by a resamp_state
+ * inputs: - resamp_state * RS
+ * returns: 0 - success, -1 - failure
+ */
+int resamp_free(resamp_state * rs);
+
+/*
+ * function: resamp_push
+ * purpose: feeds LEN timestamped samples and writes the uniform outputs that
+ * 			became computable. Outputs whose input span holds a gap are NAN
+ * 			with GAP set; totals are kept in RS->N_GAPS, RS->N_GAP_OUT and
+ * 			RS->N_DROPPED. Stops before an input whose outputs would not fit
+ * 			in CAP, RS->N_USED inputs were taken.
+ * inputs: - resamp_state * RS
+ * 		   - double * T
+ * 		   - sig_type * X
+ * 		   - int LEN
+ * 		   - double * T_OUT (may be NULL)
+ * 		   - sig_type * OUT
+ * 		   - unsigned char * GAP (may be NULL)
+ * 		   - int CAP
+ * returns: number of outputs written, -1 - failure (nothing taken)
+ */
+int resamp_push(resamp_state * rs, double * t, sig_type * x, int len,
+		double * t_out, sig_type * out, unsigned char * gap, int cap);
+
+#endif /* RESAMP_HELPER_H_ */
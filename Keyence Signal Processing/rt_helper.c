@@ -0,0 +1,258 @@
+/*
+ * rt_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: deterministic real-time execution. rt_enter pins the calling
+ *      		 thread to a core, raises it to SCHED_FIFO, locks all memory and
+ *      		 prefaults the stack so no page fault lands on the hot path.
+ *      		 rt_run then calls a step function once per period from an
+ *      		 absolute clock and records the latency from each release time to
+ *      		 the end of its step in a fixed histogram, so arbitrarily long runs
+ *      		 need no memory.
+ *
+ *      		 Built with -DRT_DEBUG, allocation and stdio calls made between
+ *      		 RT_HOT_BEGIN and RT_HOT_END abort with the file and line of the
+ *      		 call. sig_support.c pulls rt_helper.h into every module built
+ *      		 that way, so system headers have to be included before it.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "rt_helper.h"
+
+#define RT_STACK_PREFAULT (256 * 1024)
+
+#ifdef RT_DEBUG
+__thread int rt_hot;
+
+void rt_hot_violation(const char * what, const char * file, int line) {
+	// stdio may be the very thing being checked, write(2) is used instead
+	char msg[256];
+	int len = snprintf(msg, sizeof(msg), "Error: %s on real-time hot path at %s:%d!\n",
+			what, file, line);
+	if (write(STDERR_FILENO, msg, len) < 0)
+		_exit(1);
+	abort();
+}
+#endif /* RT_DEBUG */
+
+static int64_t rt_now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void rt_to_timespec(int64_t ns, struct timespec * ts) {
+	ts->tv_sec = (time_t) (ns / 1000000000);
+	ts->tv_nsec = (long) (ns % 1000000000);
+}
+
+/*
+ * function: rt_enter
+ * purpose: makes the calling thread real-time. Every step is attempted and
+ * 			reported; the thread keeps whatever could be applied.
+ * 			- CPU >= 0: pins the thread to that core
+ * 			- PRIORITY > 0: SCHED_FIFO at that priority (needs CAP_SYS_NICE)
+ * 			- LOCK_MEM: mlockall, heap kept resident, stack prefaulted
+ * 			Call after init_all so the buffers it allocated are locked too.
+ * inputs: - rt_config * CFG
+ * returns: 0 - success, -1 - one or more steps failed
+ */
+int rt_enter(rt_config * cfg) {
+	if (cfg == NULL )
+		return -1;
+	int err = 0;
+	int ret;
+
+	if (cfg->cpu >= 0) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cfg->cpu, &set);
+		ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+		if (ret != 0) {
+			printf("Error: rt_enter could not pin to cpu %d: %s!\n", cfg->cpu,
+					strerror(ret));
+			err = -1;
+		}
+	}
+
+	if (cfg->priority > 0) {
+		struct sched_param sp;
+		memset(&sp, 0, sizeof(sp));
+		sp.sched_priority = cfg->priority;
+		if (cfg->priority < sched_get_priority_min(SCHED_FIFO)
+				|| cfg->priority > sched_get_priority_max(SCHED_FIFO)) {
+			printf("Error: rt_enter priority %d out of SCHED_FIFO range!\n",
+					cfg->priority);
+			err = -1;
+		} else if ((ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp))
+				!= 0) {
+			printf("Error: rt_enter could not set SCHED_FIFO: %s!\n", strerror(ret));
+			err = -1;
+		}
+	}
+
+	if (cfg->lock_mem) {
+		// keep freed heap mapped, and off mmap, so it never faults back in
+		mallopt(M_TRIM_THRESHOLD, -1);
+		mallopt(M_MMAP_MAX, 0);
+		if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+			printf("Error: rt_enter mlockall failed: %s!\n", strerror(errno));
+			err = -1;
+		}
+		volatile unsigned char stack[RT_STACK_PREFAULT];
+		int i;
+		for (i = 0; i < RT_STACK_PREFAULT; i += 4096)
+			stack[i] = 0;
+		(void) stack[0];
+	}
+	return err;
+} /* int rt_enter */
+
+/*
+ * function: rt_leave
+ * purpose: returns the calling thread to SCHED_OTHER and unlocks memory
+ * returns: 0 - success, -1 - failure
+ */
+int rt_leave(void) {
+	struct sched_param sp;
+	memset(&sp, 0, sizeof(sp));
+	int err = 0;
+	if (pthread_setschedparam(pthread_self(), SCHED_OTHER, &sp) != 0)
+		err = -1;
+	if (munlockall() != 0)
+		err = -1;
+	return err;
+} /* int rt_leave */
+
+/*
+ * function: rt_run
+ * purpose: calls STEP every PERIOD_NS, N_CYCLES times, released from an
+ * 			absolute clock so latency does not accumulate. Latency of a cycle is
+ * 			from its release time to the return of STEP. A cycle still running
+ * 			at the next release is an overrun; missed releases are skipped.
+ * 			STEP runs between RT_HOT_BEGIN and RT_HOT_END.
+ * inputs: - long PERIOD_NS
+ * 		   - long N_CYCLES
+ * 		   - rt_step STEP
+ * 		   - void * CTX
+ * 		   - rt_stats * ST
+ * returns: 0 - success, -1 - failure
+ */
+int rt_run(long period_ns, long n_cycles, rt_step step, void * ctx, rt_stats * st) {
+	if (period_ns <= 0 || step == NULL || st == NULL )
+		return -1;
+	memset(st, 0, sizeof(rt_stats));
+	st->min_ns = INT64_MAX;
+
+	struct timespec ts;
+	int64_t release = rt_now_ns() + period_ns;
+	long i;
+	for (i = 0; i < n_cycles; i++) {
+		rt_to_timespec(release, &ts);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+			;
+		int64_t t0 = rt_now_ns();
+		RT_HOT_BEGIN();
+		int err = step(ctx, i);
+		RT_HOT_END();
+		int64_t t1 = rt_now_ns();
+
+		int64_t lat = t1 - release;
+		long bin = (long) (lat / RT_HIST_NS);
+		st->hist[(bin < RT_HIST_BINS) ? bin : RT_HIST_BINS - 1]++;
+		if (lat < st->min_ns)
+			st->min_ns = lat;
+		if (lat > st->max_ns)
+			st->max_ns = lat;
+		if (t0 - release > st->max_wake_ns)
+			st->max_wake_ns = t0 - release;
+		st->sum_ns += (double) lat;
+		st->n++;
+		if (err == -1)
+			st->errors++;
+
+		release += period_ns;
+		if (t1 > release) {
+			st->overruns++;
+			release += ((t1 - release) / period_ns + 1) * period_ns;
+		}
+	}
+	return 0;
+} /* int rt_run */
+
+// histogram bin holding percentile Q, RT_HIST_BINS - 1 is the open ended one
+static int rt_percentile_bin(rt_stats * st, double q) {
+	long target = (long) ceil(q * st->n);
+	if (target < 1)
+		target = 1;
+	long seen = 0;
+	int b;
+	for (b = 0; b < RT_HIST_BINS - 1; b++) {
+		seen += st->hist[b];
+		if (seen >= target)
+			break;
+	}
+	return b;
+}
+
+/*
+ * function: rt_percentile
+ * purpose: latency below which fraction Q of the cycles fell, to the
+ * 			RT_HIST_NS resolution of the histogram. Past the histogram range
+ * 			(the open ended last bin) only the tracked max is known, and that
+ * 			is returned as an upper bound.
+ * inputs: - rt_stats * ST
+ * 		   - double Q (0 .. 1)
+ * returns: latency in nanoseconds (upper edge of its bin, capped at the max)
+ */
+double rt_percentile(rt_stats * st, double q) {
+	if (st == NULL || st->n == 0)
+		return 0.0;
+	int b = rt_percentile_bin(st, q);
+	double edge = (double) (b + 1) * RT_HIST_NS;
+	if (b == RT_HIST_BINS - 1)
+		return (double) st->max_ns;
+	return (edge < (double) st->max_ns) ? edge : (double) st->max_ns;
+} /* double rt_percentile */
+
+/*
+ * function: rt_print
+ * purpose: prints the latency distribution of a run in microseconds. The min
+ * 			and max are exact; a percentile past the histogram range is shown
+ * 			as "> range", its true value lies between that and the max.
+ * inputs: - rt_stats * ST
+ * returns: 0 - success, -1 - failure
+ */
+int rt_print(rt_stats * st) {
+	if (st == NULL || st->n == 0)
+		return -1;
+	static const double q[4] = { 0.5, 0.99, 0.999, 0.9999 };
+	static const char * name[4] = { "p50", "p99", "p99.9", "p99.99" };
+	double range = (double) (RT_HIST_BINS - 1) * RT_HIST_NS / 1e3;
+	int i;
+	printf("cycles %ld, overruns %ld, step errors %ld\n", st->n, st->overruns,
+			st->errors);
+	printf("latency us: min %.2f mean %.2f", st->min_ns / 1e3,
+			st->sum_ns / st->n / 1e3);
+	for (i = 0; i < 4; i++) {
+		if (rt_percentile_bin(st, q[i]) == RT_HIST_BINS - 1)
+			printf(" %s > %.2f", name[i], range);
+		else
+			printf(" %s %.2f", name[i], rt_percentile(st, q[i]) / 1e3);
+	}
+	printf(" max %.2f\n", st->max_ns / 1e3);
+	printf("worst wakeup us: %.2f\n", st->max_wake_ns / 1e3);
+	return 0;
+} /* int rt_print */
@@ -0,0 +1,108 @@
+/*
+ * rt_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef RT_HELPER_H_
+#define RT_HELPER_H_
+
+#include <stdint.h>
+#include "sig_support.c"
+
+// latency histogram: RT_HIST_BINS bins of RT_HIST_NS, the last one open ended
+#define RT_HIST_NS 250
+#define RT_HIST_BINS 4000
+
+typedef struct {
+	int cpu;
+	int priority;
+	int lock_mem;
+} rt_config;
+
+typedef struct {
+	long n;
+	long overruns;
+	long errors;
+	int64_t min_ns;
+	int64_t max_ns;
+	int64_t max_wake_ns;
+	double sum_ns;
+	long hist[RT_HIST_BINS];
+} rt_stats;
+
+// step run once per period, N counts from 0. returns 0 - success, -1 - failure
+typedef int (*rt_step)(void * ctx, long n);
+
+#ifdef RT_DEBUG
+extern __thread int rt_hot;
+
+void rt_hot_violation(const char * what, const char * file, int line);
+
+#define RT_HOT_BEGIN() (rt_hot = 1)
+#define RT_HOT_END() (rt_hot = 0)
+#define RT_HOT_CHECK(what) (rt_hot ? rt_hot_violation(what, __FILE__, __LINE__) : (void) 0)
+
+#define malloc(n) (RT_HOT_CHECK("malloc"), malloc(n))
+#define calloc(n, s) (RT_HOT_CHECK("calloc"), calloc(n, s))
+#define realloc(p, n) (RT_HOT_CHECK("realloc"), realloc(p, n))
+#define free(p) (RT_HOT_CHECK("free"), free(p))
+#define fftw_malloc(n) (RT_HOT_CHECK("fftw_malloc"), fftw_malloc(n))
+#define fftw_free(p) (RT_HOT_CHECK("fftw_free"), fftw_free(p))
+#define printf(...) (RT_HOT_CHECK("printf"), printf(__VA_ARGS__))
+#define fprintf(...) (RT_HOT_CHECK("fprintf"), fprintf(__VA_ARGS__))
+#define puts(s) (RT_HOT_CHECK("puts"), puts(s))
+#define fopen(p, m) (RT_HOT_CHECK("fopen"), fopen(p, m))
+#define fwrite(p, s, n, f) (RT_HOT_CHECK("fwrite"), fwrite(p, s, n, f))
+#define fread(p, s, n, f) (RT_HOT_CHECK("fread"), fread(p, s, n, f))
+#else
+#define RT_HOT_BEGIN() ((void) 0)
+#define RT_HOT_END() ((void) 0)
+#endif /* RT_DEBUG */
+
+/*
+ * function: rt_enter
+ * purpose: pins the calling thread, sets SCHED_FIFO and locks memory
+ * inputs: - rt_config * CFG
+ * returns: 0 - success, -1 - one or more steps failed
+ */
+int rt_enter(rt_config * cfg);
+
+/*
+ * function: rt_leave
+ * purpose: returns the calling thread to SCHED_OTHER and unlocks memory
+ * returns: 0 - success, -1 - failure
+ */
+int rt_leave(void);
+
+/*
+ * function: rt_run
+ * purpose: calls STEP every PERIOD_NS and records its latency
+ * inputs: - long PERIOD_NS
+ * 		   - long N_CYCLES
+ * 		   - rt_step STEP
+ * 		   - void * CTX
+ * 		   - rt_stats * ST
+ * returns: 0 - success, -1 - failure
+ */
+int rt_run(long period_ns, long n_cycles, rt_step step, void * ctx, rt_stats * st);
+
+/*
+ * function: rt_percentile
+ * purpose: latency percentile of a run, the max past the histogram range
+ * inputs: - rt_stats * ST
+ * 		   - double Q (0 .. 1)
+ * returns: latency in nanoseconds
+ */
+double rt_percentile(rt_stats * st, double q);
+
+/*
+ * function: rt_print
+ * purpose: prints the latency distribution of a run, flagging percentiles
+ * 			past the histogram range
+ * inputs: - rt_stats * ST
+ * returns: 0 - success, -1 - failure
+ */
+int rt_print(rt_stats * st);
+
+#endif /* RT_HELPER_H_ */
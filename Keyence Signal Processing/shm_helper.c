@@ -0,0 +1,399 @@
+/*
+ * shm_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: shared memory publisher / reader for filtered samples and spectra.
+ *      		 The producer owns a POSIX shared memory ring of fixed size slots,
+ *      		 each guarded by its own sequence counter (seqlock). Publishing
+ *      		 never waits for readers; a slow reader is simply lapped. Readers
+ *      		 map the ring read only and consume frames in place: no copies and
+ *      		 no syscalls after shm_sub_open. A reader learns it fell behind
+ *      		 from the head counter (frames skipped are added to LOST) and checks
+ *      		 a frame was not overwritten while in use with shm_sub_valid.
+ */
+
+#include "shm_helper.h"
+
+static int64_t shm_now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static shm_slot * shm_slot_at(unsigned char * slots, uint64_t stride, uint64_t i) {
+	return (shm_slot *) (slots + stride * i);
+}
+
+/*
+ * function: shm_pub_open
+ * purpose: creates (or replaces) the shared memory ring NAME with N_SLOTS slots
+ * 			of SLOT_DOUBLES doubles each
+ * inputs: - shm_pub * SP
+ * 		   - char * NAME (e.g. "/keyence_filt")
+ * 		   - int N_SLOTS (power of two)
+ * 		   - int SLOT_DOUBLES
+ * returns: 0 - success, -1 - failure
+ */
+int shm_pub_open(shm_pub * sp, char * name, int n_slots, int slot_doubles) {
+	if (sp == NULL || name == NULL || strlen(name) >= sizeof(sp->name)
+			|| n_slots < 2 || (n_slots & (n_slots - 1)) != 0 || slot_doubles < 1) {
+		printf("Error: shm_pub_open invalid parameters!\n");
+		return -1;
+	}
+	memset(sp, 0, sizeof(shm_pub));
+	strcpy(sp->name, name);
+
+	uint64_t stride = sizeof(shm_slot) + sizeof(double) * slot_doubles;
+	stride = (stride + SHM_CACHE_LINE - 1) & ~(uint64_t) (SHM_CACHE_LINE - 1);
+	sp->size = sizeof(shm_header) + stride * n_slots;
+
+	int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+	if (fd == -1) {
+		printf("Error: shm_pub_open could not create %s!\n", name);
+		return -1;
+	}
+	if (ftruncate(fd, (off_t) sp->size) == -1) {
+		close(fd);
+		shm_unlink(name);
+		printf("Error: shm_pub_open could not size %s!\n", name);
+		return -1;
+	}
+	void * base = mmap(NULL, sp->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) {
+		shm_unlink(name);
+		printf("Error: shm_pub_open could not map %s!\n", name);
+		return -1;
+	}
+
+	sp->hdr = (shm_header *) base;
+	sp->slots = (unsigned char *) base + sizeof(shm_header);
+	sp->hdr->n_slots = n_slots;
+	sp->hdr->slot_doubles = slot_doubles;
+	sp->hdr->slot_stride = stride;
+	sp->hdr->version = SHM_VERSION;
+	atomic_store_explicit(&sp->hdr->head, 0, memory_order_relaxed);
+	// magic last, readers refuse a ring that is not fully set up
+	atomic_store_explicit(&sp->hdr->magic, SHM_MAGIC, memory_order_release);
+	return 0;
+} /* int shm_pub_open */
+
+/*
+ * function: shm_pub_reserve
+ * purpose: returns the payload of the next slot so the frame can be built in
+ * 			place, followed by shm_pub_commit
+ * inputs: - shm_pub * SP
+ * returns: pointer to SLOT_DOUBLES doubles, NULL - failure
+ */
+double * shm_pub_reserve(shm_pub * sp) {
+	if (sp == NULL || sp->hdr == NULL )
+		return NULL ;
+	shm_slot * s = shm_slot_at(sp->slots, sp->hdr->slot_stride,
+			sp->next & (sp->hdr->n_slots - 1));
+	// odd sequence marks the slot as being written
+	atomic_store_explicit(&s->seq, 2 * sp->next + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	return (double *) (s + 1);
+} /* double * shm_pub_reserve */
+
+/*
+ * function: shm_pub_commit
+ * purpose: publishes the slot returned by shm_pub_reserve
+ * inputs: - shm_pub * SP
+ * 		   - int KIND
+ * 		   - int LEN (doubles used)
+ * returns: 0 - success, -1 - failure
+ */
+int shm_pub_commit(shm_pub * sp, int kind, int len) {
+	if (sp == NULL || sp->hdr == NULL || len < 0
+			|| (uint32_t) len > sp->hdr->slot_doubles)
+		return -1;
+	shm_slot * s = shm_slot_at(sp->slots, sp->hdr->slot_stride,
+			sp->next & (sp->hdr->n_slots - 1));
+	s->kind = kind;
+	s->len = len;
+	s->index = sp->next;
+	s->stamp_ns = shm_now_ns();
+	atomic_store_explicit(&s->seq, 2 * sp->next + 2, memory_order_release);
+	sp->next++;
+	atomic_store_explicit(&sp->hdr->head, sp->next, memory_order_release);
+	return 0;
+} /* int shm_pub_commit */
+
+/*
+ * function: shm_publish
+ * purpose: copies LEN doubles into the next slot and publishes it. Never blocks.
+ * inputs: - shm_pub * SP
+ * 		   - int KIND (SHM_SAMPLES: sig_type samples, SHM_SPECTRUM: sig_type bins)
+ * 		   - double * DATA
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int shm_publish(shm_pub * sp, int kind, double * data, int len) {
+	if (sp == NULL || sp->hdr == NULL || len < 0
+			|| (uint32_t) len > sp->hdr->slot_doubles)
+		return -1;
+	double * dst = shm_pub_reserve(sp);
+	memcpy(dst, data, sizeof(double) * len);
+	return shm_pub_commit(sp, kind, len);
+} /* int shm_publish */
+
+/*
+ * function: shm_pub_close
+ * purpose: unmaps and removes the ring. Mapped readers keep their view.
+ * inputs: - shm_pub * SP
+ * returns: 0 - success, -1 - failure
+ */
+int shm_pub_close(shm_pub * sp) {
+	if (sp == NULL || sp->hdr == NULL )
+		return -1;
+	munmap(sp->hdr, sp->size);
+	shm_unlink(sp->name);
+	sp->hdr = NULL;
+	return 0;
+} /* int shm_pub_close */
+
+/*
+ * function: shm_sub_open
+ * purpose: maps the ring NAME read only. Reading starts at the newest frame.
+ * inputs: - shm_sub * SS
+ * 		   - char * NAME
+ * returns: 0 - success, -1 - failure
+ */
+int shm_sub_open(shm_sub * ss, char * name) {
+	if (ss == NULL || name == NULL )
+		return -1;
+	memset(ss, 0, sizeof(shm_sub));
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd == -1) {
+		printf("Error: shm_sub_open could not open %s!\n", name);
+		return -1;
+	}
+	struct stat st;
+	if (fstat(fd, &st) == -1 || (size_t) st.st_size < sizeof(shm_header)) {
+		close(fd);
+		printf("Error: shm_sub_open %s is not a ring!\n", name);
+		return -1;
+	}
+	void * base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) {
+		printf("Error: shm_sub_open could not map %s!\n", name);
+		return -1;
+	}
+	ss->size = st.st_size;
+	ss->hdr = (const shm_header *) base;
+	ss->slots = (const unsigned char *) base + sizeof(shm_header);
+	// the geometry must be one shm_pub_open makes and fit the mapping. It
+	// is only read once the magic, stored after it, is seen with acquire
+	const shm_header * h = ss->hdr;
+	uint32_t magic = atomic_load_explicit(&((shm_header *) h)->magic,
+			memory_order_acquire);
+	uint64_t min_stride = sizeof(shm_slot) + sizeof(double) * (uint64_t) h->slot_doubles;
+	if (magic != SHM_MAGIC || h->version != SHM_VERSION || h->n_slots < 2
+			|| (h->n_slots & (h->n_slots - 1)) != 0 || h->slot_doubles < 1
+			|| h->slot_stride < min_stride || h->slot_stride % SHM_CACHE_LINE != 0
+			|| h->slot_stride > (ss->size - sizeof(shm_header)) / h->n_slots) {
+		munmap(base, ss->size);
+		ss->hdr = NULL;
+		printf("Error: shm_sub_open %s has no valid header!\n", name);
+		return -1;
+	}
+	uint64_t head = atomic_load_explicit(
+			&((shm_header *) ss->hdr)->head, memory_order_acquire);
+	ss->cursor = (head > 0) ? head - 1 : 0;
+	return 0;
+} /* int shm_sub_open */
+
+/*
+ * function: shm_sub_lag
+ * purpose: number of published frames the reader has not consumed yet
+ * inputs: - shm_sub * SS
+ * returns: frames behind the producer, 0 for a closed reader
+ */
+uint64_t shm_sub_lag(shm_sub * ss) {
+	if (ss == NULL || ss->hdr == NULL )
+		return 0;
+	uint64_t head = atomic_load_explicit(
+			&((shm_header *) ss->hdr)->head, memory_order_acquire);
+	return (head > ss->cursor) ? head - ss->cursor : 0;
+} /* uint64_t shm_sub_lag */
+
+/*
+ * function: shm_sub_next
+ * purpose: fetches the next frame in place. If the reader fell more than a ring
+ * 			behind it skips ahead and the skipped frames are added to SS->LOST.
+ * 			Check shm_sub_valid after using FRAME->DATA.
+ * inputs: - shm_sub * SS
+ * 		   - shm_frame * FRAME
+ * returns: 1 - frame available, 0 - nothing new, -1 - failure
+ */
+int shm_sub_next(shm_sub * ss, shm_frame * frame) {
+	if (ss == NULL || ss->hdr == NULL || frame == NULL )
+		return -1;
+	uint64_t n = ss->hdr->n_slots;
+
+	while (1) {
+		uint64_t head = atomic_load_explicit(
+				&((shm_header *) ss->hdr)->head, memory_order_acquire);
+		if (ss->cursor >= head)
+			return 0;
+		if (head - ss->cursor > n) {
+			ss->lost += head - ss->cursor - n;
+			ss->cursor = head - n;
+		}
+
+		const shm_slot * s = (const shm_slot *) (ss->slots
+				+ ss->hdr->slot_stride * (ss->cursor & (n - 1)));
+		uint64_t seq = atomic_load_explicit(&((shm_slot *) s)->seq,
+				memory_order_acquire);
+		if (seq == 2 * ss->cursor + 2) {
+			frame->index = ss->cursor;
+			frame->kind = s->kind;
+			frame->len = s->len;
+			frame->stamp_ns = s->stamp_ns;
+			frame->data = (const double *) (s + 1);
+			frame->slot = s;
+			ss->cursor++;
+			return 1;
+		}
+		// lapped while looking at it, count it and move on
+		ss->lost++;
+		ss->cursor++;
+	}
+} /* int shm_sub_next */
+
+/*
+ * function: shm_sub_valid
+ * purpose: confirms FRAME was not overwritten while the reader used it
+ * inputs: - shm_sub * SS
+ * 		   - shm_frame * FRAME
+ * returns: 1 - frame intact, 0 - frame was overwritten (discard what was read)
+ */
+int shm_sub_valid(shm_sub * ss, shm_frame * frame) {
+	atomic_thread_fence(memory_order_acquire);
+	uint64_t seq = atomic_load_explicit(&((shm_slot *) frame->slot)->seq,
+			memory_order_relaxed);
+	if (seq == 2 * frame->index + 2)
+		return 1;
+	ss->lost++;
+	return 0;
+} /* int shm_sub_valid */
+
+/*
+ * function: shm_sub_close
+ * purpose: unmaps the ring
+ * inputs: - shm_sub * SS
+ * returns: 0 - success, -1 - failure
+ */
+int shm_sub_close(shm_sub * ss) {
+	if (ss == NULL || ss->hdr == NULL )
+		return -1;
+	munmap((void *) ss->hdr, ss->size);
+	ss->hdr = NULL;
+	return 0;
+} /* int shm_sub_close */
+
+typedef struct {
+	char * name;
+	long n_frames;
+	int64_t * lat;
+	long n_lat;
+	uint64_t lost;
+	atomic_int ready;
+	atomic_int stop;
+} shm_bench_ctx;
+
+static void * shm_bench_reader(void * arg) {
+	shm_bench_ctx * c = (shm_bench_ctx *) arg;
+	shm_sub ss;
+	if (shm_sub_open(&ss, c->name) == -1) {
+		atomic_store(&c->ready, -1);
+		return NULL ;
+	}
+	atomic_store(&c->ready, 1);
+	shm_frame f;
+	while (c->n_lat < c->n_frames) {
+		int r = shm_sub_next(&ss, &f);
+		if (r == 1) {
+			int64_t t = shm_now_ns();
+			if (shm_sub_valid(&ss, &f))
+				c->lat[c->n_lat++] = t - f.stamp_ns;
+		} else if (atomic_load(&c->stop)) {
+			break;
+		}
+	}
+	c->lost = ss.lost;
+	shm_sub_close(&ss);
+	return NULL ;
+}
+
+static int shm_cmp_i64(const void * a, const void * b) {
+	int64_t x = *(const int64_t *) a;
+	int64_t y = *(const int64_t *) b;
+	return (x > y) - (x < y);
+}
+
+/*
+ * function: shm_bench
+ * purpose: publish-to-read latency of the ring. A reader thread with its own
+ * 			mapping spins on the ring while N_FRAMES frames of LEN doubles are
+ * 			published every PERIOD_NS. Reports percentiles in nanoseconds.
+ * inputs: - char * NAME
+ * 		   - long N_FRAMES
+ * 		   - int LEN
+ * 		   - long PERIOD_NS
+ * 		   - double * P50
+ * 		   - double * P99
+ * 		   - double * MAX
+ * 		   - long * LOST
+ * returns: 0 - success, -1 - failure
+ */
+int shm_bench(char * name, long n_frames, int len, long period_ns, double * p50,
+		double * p99, double * max, long * lost) {
+	shm_pub sp;
+	if (shm_pub_open(&sp, name, 1024, len) == -1)
+		return -1;
+
+	shm_bench_ctx c;
+	memset(&c, 0, sizeof(c));
+	c.name = name;
+	c.n_frames = n_frames;
+	c.lat = (int64_t *) malloc(sizeof(int64_t) * n_frames);
+	double * data = (double *) calloc(len, sizeof(double));
+	pthread_t th;
+	if (c.lat == NULL || data == NULL
+			|| pthread_create(&th, NULL, shm_bench_reader, &c) != 0) {
+		free(c.lat);
+		free(data);
+		shm_pub_close(&sp);
+		return -1;
+	}
+	while (atomic_load(&c.ready) == 0)
+		;
+
+	long i;
+	for (i = 0; i < n_frames && atomic_load(&c.ready) == 1; i++) {
+		int64_t t0 = shm_now_ns();
+		data[0] = (double) i;
+		shm_publish(&sp, SHM_SAMPLES, data, len);
+		while (shm_now_ns() - t0 < period_ns)
+			;
+	}
+	atomic_store(&c.stop, 1);
+	pthread_join(th, NULL);
+
+	int err = (c.n_lat > 0) ? 0 : -1;
+	if (err == 0) {
+		qsort(c.lat, c.n_lat, sizeof(int64_t), shm_cmp_i64);
+		*p50 = (double) c.lat[c.n_lat / 2];
+		*p99 = (double) c.lat[(long) (c.n_lat * 0.99)];
+		*max = (double) c.lat[c.n_lat - 1];
+		*lost = (long) c.lost;
+	}
+	free(c.lat);
+	free(data);
+	shm_pub_close(&sp);
+	return err;
+} /* int shm_bench */
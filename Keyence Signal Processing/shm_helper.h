@@ -0,0 +1,182 @@
+/*
+ * shm_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SHM_HELPER_H_
+#define SHM_HELPER_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sig_support.c"
+
+#define SHM_MAGIC 0x4b534d31u
+#define SHM_VERSION 1
+#define SHM_CACHE_LINE 64
+
+// frame kinds
+#define SHM_SAMPLES 0
+#define SHM_SPECTRUM 1
+
+typedef struct {
+	// stored last with release by shm_pub_open, loaded with acquire
+	_Atomic uint32_t magic;
+	uint32_t version;
+	uint32_t n_slots;
+	uint32_t slot_doubles;
+	uint64_t slot_stride;
+	_Atomic uint64_t head;
+	char pad[SHM_CACHE_LINE - 32];
+} shm_header;
+
+typedef struct {
+	_Atomic uint64_t seq;
+	int32_t kind;
+	int32_t len;
+	int64_t stamp_ns;
+	uint64_t index;
+	// followed by slot_doubles doubles
+} shm_slot;
+
+typedef struct {
+	char name[64];
+	size_t size;
+	shm_header * hdr;
+	unsigned char * slots;
+	uint64_t next;
+} shm_pub;
+
+typedef struct {
+	size_t size;
+	const shm_header * hdr;
+	const unsigned char * slots;
+	uint64_t cursor;
+	uint64_t lost;
+} shm_sub;
+
+// a frame as seen by a reader, DATA points into the shared mapping
+typedef struct {
+	uint64_t index;
+	int kind;
+	int len;
+	int64_t stamp_ns;
+	const double * data;
+	const shm_slot * slot;
+} shm_frame;
+
+/*
+ * function: shm_pub_open
+ * purpose: creates (or replaces) the shared memory ring NAME
+ * inputs: - shm_pub * SP
+ * 		   - char * NAME
+ * 		   - int N_SLOTS (power of two)
+ * 		   - int SLOT_DOUBLES
+ * returns: 0 - success, -1 - failure
+ */
+int shm_pub_open(shm_pub * sp, char * name, int n_slots, int slot_doubles);
+
+/*
+ * function: shm_pub_reserve
+ * purpose: returns the payload of the next slot to build a frame in place
+ * inputs: - shm_pub * SP
+ * returns: pointer to SLOT_DOUBLES doubles, NULL - failure
+ */
+double * shm_pub_reserve(shm_pub * sp);
+
+/*
+ * function: shm_pub_commit
+ * purpose: publishes the slot returned by shm_pub_reserve
+ * inputs: - shm_pub * SP
+ * 		   - int KIND
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int shm_pub_commit(shm_pub * sp, int kind, int len);
+
+/*
+ * function: shm_publish
+ * purpose: copies LEN doubles into the next slot and publishes it. Never blocks.
+ * inputs: - shm_pub * SP
+ * 		   - int KIND (SHM_SAMPLES, SHM_SPECTRUM)
+ * 		   - double * DATA
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int shm_publish(shm_pub * sp, int kind, double * data, int len);
+
+/*
+ * function: shm_pub_close
+ * purpose: unmaps and removes the ring
+ * inputs: - shm_pub * SP
+ * returns: 0 - success, -1 - failure
+ */
+int shm_pub_close(shm_pub * sp);
+
+/*
+ * function: shm_sub_open
+ * purpose: maps the ring NAME read only, starting at the newest frame
+ * inputs: - shm_sub * SS
+ * 		   - char * NAME
+ * returns: 0 - success, -1 - failure
+ */
+int shm_sub_open(shm_sub * ss, char * name);
+
+/*
+ * function: shm_sub_lag
+ * purpose: number of published frames the reader has not consumed yet
+ * inputs: - shm_sub * SS
+ * returns: frames behind the producer, 0 for a closed reader
+ */
+uint64_t shm_sub_lag(shm_sub * ss);
+
+/*
+ * function: shm_sub_next
+ * purpose: fetches the next frame in place, skipping ahead (and counting
+ * 			SS->LOST) if the producer lapped the reader
+ * inputs: - shm_sub * SS
+ * 		   - shm_frame * FRAME
+ * returns: 1 - frame available, 0 - nothing new, -1 - failure
+ */
+int shm_sub_next(shm_sub * ss, shm_frame * frame);
+
+/*
+ * function: shm_sub_valid
+ * purpose: confirms FRAME was not overwritten while the reader used it
+ * inputs: - shm_sub * SS
+ * 		   - shm_frame * FRAME
+ * returns: 1 - frame intact, 0 - frame was overwritten
+ */
+int shm_sub_valid(shm_sub * ss, shm_frame * frame);
+
+/*
+ * function: shm_sub_close
+ * purpose: unmaps the ring
+ * inputs: - shm_sub * SS
+ * returns: 0 - success, -1 - failure
+ */
+int shm_sub_close(shm_sub * ss);
+
+/*
+ * function: shm_bench
+ * purpose: publish-to-read latency of the ring, percentiles in nanoseconds
+ * inputs: - char * NAME
+ * 		   - long N_FRAMES
+ * 		   - int LEN
+ * 		   - long PERIOD_NS
+ * 		   - double * P50
+ * 		   - double * P99
+ * 		   - double * MAX
+ * 		   - long * LOST
+ * returns: 0 - success, -1 - failure
+ */
+int shm_bench(char * name, long n_frames, int len, long period_ns, double * p50,
+		double * p99, double * max, long * lost);
+
+#endif /* SHM_HELPER_H_ */
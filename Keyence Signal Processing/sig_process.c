@@ -6,8 +6,30 @@
  *    Organization: N12 Technologies
  */
 
+// first, so its hot path checks see every call made after it
+#include "rt_helper.h"
 #include "filter_support.h"
 #include "fft_support.h"
+#include "swap_helper.h"
+#include "geom_helper.h"
+#include "quant_helper.h"
+#include "event_helper.h"
+
+// live filter coefficients, swapped at run time by filt_redesign
+coef_swap FSW;
+
+// cross channel geometry calibration and its per sample outputs
+geom_cal GEO;
+double geom_output[GEOM_MAX_OUT];
+
+// per channel distribution of filt_output, for percentile reports
+qs_sketch QS;
+
+// step / edge detector on filt_output, off until set up with ev_init.
+// EV_COUNT events of the latest sample are in EV_OUT
+ev_det EV;
+ev_event EV_OUT[OUT_NUM];
+int EV_COUNT;
 
 /*
  * function: init_all
@@ -20,6 +42,10 @@
  * 					 - int FB_alloc()
  * 					 - int fft_init();
  * 					 - int filt_coeffs(double FL, double FH, double FS, int win_type, int filt_type);
+ * 					 - int swap_init(coef_swap * CS, int CAP, double * TAPS, int LEN);
+ * 					 - int swap_tune(coef_swap * CS, int FB_LEN, char * CACHE);
+ * 					 - int geom_init(geom_cal * GC);
+ * 					 - int qs_init(qs_sketch * QS, double COMPRESSION);
  *
  * returns: 0 - success, -1 - failure
  */
@@ -66,6 +92,43 @@ int init_all(){
 	if (err == -1){
 		printf("Error: init_all error - filt_coeffs failed!");
 		return -1;
+	} printf(" .");
+
+	/*
+	 * hand the coefficients to the swap buffer read by filter_process
+	 */
+	err = swap_init(&FSW, BUFFER_LEN, F, BUFFER_LEN);
+	if (err == -1){
+		printf("Error: init_all error - swap_init failed!");
+		return -1;
+	} printf(" .");
+
+	/*
+	 * direct or folded convolution, whichever is faster on this host
+	 * over the running buffer as filter_process uses it
+	 */
+	err = swap_tune(&FSW, BUFFER_LEN, TUNE_CACHE);
+	if (err == -1){
+		printf("Error: init_all error - swap_tune failed!");
+		return -1;
+	} printf(" .");
+
+	/*
+	 * no derived geometry until a calibration is loaded with geom_load
+	 */
+	err = geom_init(&GEO);
+	if (err == -1){
+		printf("Error: init_all error - geom_init failed!");
+		return -1;
+	} printf(" .");
+
+	/*
+	 * quantile sketch of the filtered heights, reset with qs_reset per shift
+	 */
+	err = qs_init(&QS, QS_DEFAULT_COMPRESSION);
+	if (err == -1){
+		printf("Error: init_all error - qs_init failed!");
+		return -1;
 	} printf(" .\n");
 
 	printf("init_all successful!\n");
@@ -73,6 +136,53 @@ int init_all(){
 
 } /* int init_all */
 
+/*
+ * function: filt_redesign
+ * purpose: redesigns the filter while the stream is running. Coefficients are
+ * 			computed in the calling thread and published to FSW; filter_process
+ * 			switches to them at its next sample without locking. The taps are
+ * 			designed aside; W and F change only once they are published, so a
+ * 			failed or deferred redesign leaves them describing the live filter.
+ * 			The live filter has BUFFER_LEN taps, so high-pass needs an odd
+ * 			BUFFER_LEN.
+ * inputs: - double F_LOW
+ * 		   - double F_HIGH
+ * 		   - double FS
+ * 		   - int win_type
+ * 		   - int filt_type
+ * 		   - int xfade (samples to crossfade old and new outputs, 0: hard switch)
+ * returns: 0 - success, 1 - previous redesign still switching, -1 - failure
+ *
+ * functions called: - int fir_taps(double F_LOW, double F_HIGH, double FS, int WIN_TYPE, int FILT_TYPE, double * H, int N);
+ * 					 - int swap_publish(coef_swap * CS, double * TAPS, int LEN, int XFADE);
+ * 					 - int window_coeffs(int wintype);
+ */
+int filt_redesign(double F_LOW, double F_HIGH, double FS, int win_type,
+		int filt_type, int xfade){
+	if (filt_type == HIGHPASS && BUFFER_LEN % 2 == 0){
+		printf("Error: filt_redesign error - high-pass needs an odd BUFFER_LEN!");
+		return -1;
+	}
+	double * taps = (double *) malloc(sizeof(double) * BUFFER_LEN);
+	if (taps == NULL){
+		printf("Error: filt_redesign error - failed mem allocation!");
+		return -1;
+	}
+	int err = fir_taps(F_LOW, F_HIGH, FS, win_type, filt_type, taps, BUFFER_LEN);
+	if (err == -1){
+		printf("Error: filt_redesign error - fir_taps failed!");
+		free(taps);
+		return -1;
+	}
+	err = swap_publish(&FSW, taps, BUFFER_LEN, xfade);
+	if (err == 0){
+		memcpy(F, taps, sizeof(double) * BUFFER_LEN);
+		window_coeffs(win_type);
+	}
+	free(taps);
+	return err;
+} /* int filt_redesign */
+
 /*
  * function: shift_buffer
  * purpose: shifts the buffer of interest left or right
@@ -133,16 +243,23 @@ int shift_buffer(int dir, double * dp, sig_type * sp, int * ip, float * fp, char
 		printf("Error: shift_buffer could not resolve direction of shift!");
 		return -1;
 	}
-	printf("success\n");
 	return 0;
 }/* int shift_buffer */
 
 /*
  * function: filter_process
  * purpose: performs a convolution of the input signal.
+ * 			coefficients come from FSW and may change between samples.
+ * 			the filtered sample is then combined into geom_output with GEO
+ * 			and added to the quantile sketch QS. when EV is set up, steps
+ * 			and edges it completes are left in EV_OUT / EV_COUNT.
  * returns: 0 - success, -1 - failure
  *
  * functions called: - int shift_buffer()
+ * 					 - int swap_convolve(coef_swap * CS, sig_type * FB, int FB_LEN, double * OUTPUT)
+ * 					 - int geom_process(geom_cal * GC, sig_type INPUT, double * OUTPUT)
+ * 					 - int qs_add(qs_sketch * QS, sig_type INPUT)
+ * 					 - int ev_process(ev_det * ED, sig_type INPUT, ev_event * EV)
  */
 int filter_process(double *input){
 	int err = 0;
@@ -152,16 +269,63 @@ int filter_process(double *input){
 
 	int i;
 	for(i = 0; i < OUT_NUM; i++)
-		*(FB + BUFFER_LEN - 1)[i] = *(input + i);
-	int j;
-	for (i = 0; i < BUFFER_LEN; i++){
-		for (j = 0; j < OUT_NUM; j++){
-			filt_output[j] = filt_output[j] + (F[i] * (*(FB + i)[j]));
-		}
-	}
-	return err;
+		FB[BUFFER_LEN - 1][i] = *(input + i);
+
+	err = swap_convolve(&FSW, FB, BUFFER_LEN, filt_output);
+	if (err == -1)
+		return err;
+
+	if (GEO.n_out > 0)
+		geom_process(&GEO, filt_output, geom_output);
+	EV_COUNT = 0;
+	if (EV.mode != EV_OFF && (EV_COUNT = ev_process(&EV, filt_output, EV_OUT)) == -1)
+		return -1;
+	return qs_add(&QS, filt_output);
 } /* int filter_process */
 
+// one synthetic sample per cycle through filter_process
+static int realtime_step(void * ctx, long n){
+	(void) ctx;
+	double input[OUT_NUM];
+	int i;
+	for(i = 0; i < OUT_NUM; i++)
+		input[i] = sin(2 * pi * FL * n / SR + i);
+	return filter_process(input);
+}
+
+/*
+ * function: realtime_bench
+ * purpose: runs filter_process in real-time mode once per period and prints
+ * 			the latency distribution from sample release to filtered output.
+ * 			init_all must have been called. Real-time setup failures (e.g. no
+ * 			permission for SCHED_FIFO) are reported and the run continues.
+ * inputs: - int cpu (-1: not pinned)
+ * 		   - int priority (SCHED_FIFO priority, 0: not real-time)
+ * 		   - long period_ns
+ * 		   - long n_cycles
+ * returns: 0 - success, -1 - failure
+ *
+ * functions called: - int rt_enter(rt_config * CFG)
+ * 					 - int rt_run(long PERIOD_NS, long N_CYCLES, rt_step STEP, void * CTX, rt_stats * ST)
+ * 					 - int rt_print(rt_stats * ST)
+ * 					 - int rt_leave(void)
+ */
+int realtime_bench(int cpu, int priority, long period_ns, long n_cycles){
+	// rt_stats holds the whole histogram, too big for the locked stack
+	static rt_stats st;
+	rt_config cfg = { cpu, priority, 1 };
+
+	if (rt_enter(&cfg) == -1)
+		printf("Warning: realtime_bench running without full real-time setup!\n");
+	int err = rt_run(period_ns, n_cycles, realtime_step, NULL, &st);
+	rt_leave();
+	if (err == -1){
+		printf("Error: realtime_bench error - rt_run failed!");
+		return -1;
+	}
+	return rt_print(&st);
+} /* int realtime_bench */
+
 int spectral_process(){
 	int err = 0;
 	err = shift_buffer(1)
@@ -6,6 +6,9 @@
  * Organization: N12 Technologies
  */
 
+#ifndef SIG_SUPPORT_C_
+#define SIG_SUPPORT_C_
+
 // libraries to be included
 #include <stdio.h>
 #include <stdlib.h>
@@ -18,3 +21,10 @@
 
 // define new type called sig_type (multi dimensional array)
 typedef double sig_type[OUT_NUM];
+
+// -DRT_DEBUG: allocation and stdio checks on the real-time hot path
+#ifdef RT_DEBUG
+#include "rt_helper.h"
+#endif
+
+#endif /* SIG_SUPPORT_C_ */
@@ -0,0 +1,292 @@
+/*
+ * stft_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: short time fourier transform / spectrogram engine. Frames of
+ *      		 FFT_LEN samples, HOP apart, are windowed with win_gen and
+ *      		 transformed with one cached FFTW plan (plan_get) shared by every
+ *      		 channel, thread and engine of that length. Magnitude frames go
+ *      		 to a callback and / or a compact spectrogram file:
+ *
+ *      		   header: char[4] "KSTF", int32 version, int32 fft_len, int32 hop,
+ *      		           int32 n_bins, int32 n_chan, double fs
+ *      		   frame:  int64 index, float mag[n_bins][n_chan]
+ *
+ *      		 stft_push streams live samples, stft_batch spreads a recorded
+ *      		 capture over several cores and still emits frames in order.
+ */
+
+#include "stft_helper.h"
+
+/*
+ * function: stft_init
+ * purpose: allocates buffers, computes the analysis window and plans the FFT
+ * inputs: - stft_engine * SE
+ * 		   - int FFT_LEN
+ * 		   - int HOP (1 .. FFT_LEN)
+ * 		   - int WIN_TYPE
+ * 		   - double FS
+ * returns: 0 - success, -1 - failure
+ * Codes for int win_type: 0: Hanning, 1: Hamming, 2: Blackman, 3: Blackman-Harris
+ */
+int stft_init(stft_engine * se, int fft_len, int hop, int win_type, double fs) {
+	if (se == NULL || fft_len < 2 || hop < 1 || hop > fft_len) {
+		printf("Error: stft_init invalid parameters!\n");
+		return -1;
+	}
+	memset(se, 0, sizeof(stft_engine));
+	se->fft_len = fft_len;
+	se->hop = hop;
+	se->n_bins = fft_len / 2 + 1;
+	se->fs = fs;
+
+	se->win = (double *) malloc(sizeof(double) * fft_len);
+	se->scratch = (double *) fftw_malloc(sizeof(double) * fft_len);
+	se->spec = (fftw_complex *) fftw_malloc(sizeof(fftw_complex) * se->n_bins);
+	se->hist = (sig_type *) calloc(fft_len, sizeof(sig_type));
+	se->mag = (sig_type *) malloc(sizeof(sig_type) * se->n_bins);
+	se->fbuf = (float *) malloc(sizeof(float) * se->n_bins * OUT_NUM);
+	if (se->win == NULL || se->scratch == NULL || se->spec == NULL
+			|| se->hist == NULL || se->mag == NULL || se->fbuf == NULL ) {
+		printf("Error: stft_init failed mem allocation!\n");
+		return -1;
+	}
+	if (win_gen(win_type, se->win, fft_len, 1) == -1)
+		return -1;
+
+	se->plan = plan_get(fft_len, PLAN_R2C, 1, 1);
+	return (se->plan == NULL ) ? -1 : 0;
+} /* int stft_init */
+
+/*
+ * function: stft_set_callback
+ * purpose: sets the function that receives each magnitude frame
+ * inputs: - stft_engine * SE
+ * 		   - stft_cb CB
+ * 		   - void * CTX
+ * returns: 0 - success, -1 - failure
+ */
+int stft_set_callback(stft_engine * se, stft_cb cb, void * ctx) {
+	if (se == NULL )
+		return -1;
+	se->cb = cb;
+	se->cb_ctx = ctx;
+	return 0;
+} /* int stft_set_callback */
+
+/*
+ * function: stft_open
+ * purpose: starts writing frames to a spectrogram file at PATH
+ * inputs: - stft_engine * SE
+ * 		   - char * PATH
+ * returns: 0 - success, -1 - failure
+ */
+int stft_open(stft_engine * se, char * path) {
+	if (se == NULL || se->fp != NULL )
+		return -1;
+	se->fp = fopen(path, "wb");
+	if (se->fp == NULL ) {
+		printf("Error: stft_open could not open %s!\n", path);
+		return -1;
+	}
+	int32_t hdr[5] = { STFT_VERSION, se->fft_len, se->hop, se->n_bins, OUT_NUM };
+	if (fwrite("KSTF", 1, 4, se->fp) != 4 || fwrite(hdr, sizeof(hdr), 1, se->fp) != 1
+			|| fwrite(&se->fs, sizeof(double), 1, se->fp) != 1) {
+		printf("Error: stft_open failed writing header!\n");
+		return -1;
+	}
+	return 0;
+} /* int stft_open */
+
+/*
+ * function: stft_free
+ * purpose: closes the spectrogram file and releases the engine
+ * inputs: - stft_engine * SE
+ * returns: 0 - success, -1 - failure
+ */
+int stft_free(stft_engine * se) {
+	if (se == NULL )
+		return -1;
+	int err = 0;
+	if (se->fp != NULL && fclose(se->fp) != 0)
+		err = -1;
+	free(se->win);
+	fftw_free(se->scratch);
+	fftw_free(se->spec);
+	free(se->hist);
+	free(se->mag);
+	free(se->fbuf);
+	memset(se, 0, sizeof(stft_engine));
+	return err;
+} /* int stft_free */
+
+// windowed FFT magnitude of FFT_LEN samples starting at X, all channels
+static void stft_frame(stft_engine * se, sig_type * x, double * scratch,
+		fftw_complex * spec, sig_type * mag) {
+	int i, j, k;
+	for (j = 0; j < OUT_NUM; j++) {
+		for (i = 0; i < se->fft_len; i++)
+			scratch[i] = x[i][j] * se->win[i];
+		fftw_execute_dft_r2c(se->plan, scratch, spec);
+		for (k = 0; k < se->n_bins; k++)
+			mag[k][j] = sqrt(spec[k][0] * spec[k][0] + spec[k][1] * spec[k][1]);
+	}
+}
+
+// hands one frame to the callback and file
+static int stft_emit(stft_engine * se, sig_type * mag) {
+	if (se->cb != NULL )
+		se->cb(se->cb_ctx, se->frame, mag, se->n_bins);
+	if (se->fp != NULL ) {
+		int k, j;
+		int64_t index = se->frame;
+		for (k = 0; k < se->n_bins; k++)
+			for (j = 0; j < OUT_NUM; j++)
+				se->fbuf[k * OUT_NUM + j] = (float) mag[k][j];
+		if (fwrite(&index, sizeof(int64_t), 1, se->fp) != 1
+				|| fwrite(se->fbuf, sizeof(float), se->n_bins * OUT_NUM, se->fp)
+						!= (size_t) se->n_bins * OUT_NUM) {
+			printf("Error: stft_emit failed writing frame %ld!\n", se->frame);
+			return -1;
+		}
+	}
+	se->frame++;
+	return 0;
+}
+
+/*
+ * function: stft_push
+ * purpose: streams LEN samples into the engine, emitting a frame every HOP
+ * 			samples once FFT_LEN samples have been seen
+ * inputs: - stft_engine * SE
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int stft_push(stft_engine * se, sig_type * in, int len) {
+	if (se == NULL || se->plan == NULL )
+		return -1;
+	int n;
+	for (n = 0; n < len; n++) {
+		memcpy(se->hist[se->fill], in[n], sizeof(sig_type));
+		if (++se->fill < se->fft_len)
+			continue;
+		stft_frame(se, se->hist, se->scratch, se->spec, se->mag);
+		if (stft_emit(se, se->mag) == -1)
+			return -1;
+		memmove(se->hist, se->hist + se->hop,
+				sizeof(sig_type) * (se->fft_len - se->hop));
+		se->fill = se->fft_len - se->hop;
+	}
+	return 0;
+} /* int stft_push */
+
+typedef struct {
+	stft_engine * se;
+	sig_type * in;
+	sig_type * mag;
+	long f0;
+	int n_frames;
+	int threaded;
+	int err;
+} stft_task;
+
+static void * stft_worker(void * arg) {
+	stft_task * t = (stft_task *) arg;
+	stft_engine * se = t->se;
+	double * scratch = (double *) fftw_malloc(sizeof(double) * se->fft_len);
+	fftw_complex * spec = (fftw_complex *) fftw_malloc(
+			sizeof(fftw_complex) * se->n_bins);
+	if (scratch == NULL || spec == NULL ) {
+		t->err = -1;
+	} else {
+		int f;
+		for (f = 0; f < t->n_frames; f++)
+			stft_frame(se, t->in + (t->f0 + f) * se->hop, scratch, spec,
+					t->mag + (size_t) f * se->n_bins);
+	}
+	fftw_free(scratch);
+	fftw_free(spec);
+	return NULL ;
+}
+
+/*
+ * function: stft_batch
+ * purpose: spectrogram of a whole recorded capture. Frames are computed in
+ * 			rounds spread over N_THREADS and emitted in order after each round.
+ * 			Independent of the stft_push history.
+ * inputs: - stft_engine * SE
+ * 		   - sig_type * IN
+ * 		   - long LEN
+ * 		   - int N_THREADS (0: one per online core)
+ * returns: 0 - success, -1 - failure
+ */
+int stft_batch(stft_engine * se, sig_type * in, long len, int n_threads) {
+	if (se == NULL || se->plan == NULL || in == NULL )
+		return -1;
+	if (len < se->fft_len)
+		return 0;
+
+	if (n_threads <= 0)
+		n_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if (n_threads < 1)
+		n_threads = 1;
+
+	long n_frames = (len - se->fft_len) / se->hop + 1;
+	int round = STFT_ROUND * n_threads;
+	sig_type * mag = (sig_type *) malloc(
+			sizeof(sig_type) * (size_t) round * se->n_bins);
+	stft_task * task = (stft_task *) malloc(sizeof(stft_task) * n_threads);
+	pthread_t * th = (pthread_t *) malloc(sizeof(pthread_t) * n_threads);
+	if (mag == NULL || task == NULL || th == NULL ) {
+		free(mag);
+		free(task);
+		free(th);
+		printf("Error: stft_batch failed mem allocation!\n");
+		return -1;
+	}
+
+	int err = 0;
+	long f0;
+	for (f0 = 0; f0 < n_frames && err == 0; f0 += round) {
+		int in_round = (n_frames - f0 < round) ? (int) (n_frames - f0) : round;
+		int per = (in_round + n_threads - 1) / n_threads;
+		int i;
+		for (i = 0; i < n_threads; i++) {
+			int first = i * per;
+			task[i].se = se;
+			task[i].in = in;
+			task[i].f0 = f0 + first;
+			task[i].n_frames = (first >= in_round) ? 0 :
+						(first + per > in_round) ? in_round - first : per;
+			task[i].mag = mag + (size_t) first * se->n_bins;
+			task[i].threaded = 0;
+			task[i].err = 0;
+		}
+		// the calling thread takes task 0, and any task a thread can't be made for
+		for (i = 1; i < n_threads; i++) {
+			if (task[i].n_frames == 0)
+				break;
+			if (pthread_create(&th[i], NULL, stft_worker, &task[i]) == 0)
+				task[i].threaded = 1;
+			else
+				stft_worker(&task[i]);
+		}
+		stft_worker(&task[0]);
+		for (i = 1; i < n_threads; i++)
+			if (task[i].threaded)
+				pthread_join(th[i], NULL);
+
+		for (i = 0; i < n_threads; i++)
+			if (task[i].err == -1)
+				err = -1;
+		for (i = 0; i < in_round && err == 0; i++)
+			err = stft_emit(se, mag + (size_t) i * se->n_bins);
+	}
+
+	free(mag);
+	free(task);
+	free(th);
+	return err;
+} /* int stft_batch */
@@ -0,0 +1,105 @@
+/*
+ * stft_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef STFT_HELPER_H_
+#define STFT_HELPER_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "filter_helper.h"
+#include "plan_helper.h"
+
+#define STFT_VERSION 1
+#define STFT_ROUND 32
+
+// callback receives N_BINS magnitude bins per channel, frame INDEX counts from 0
+typedef void (*stft_cb)(void * ctx, long index, sig_type * mag, int n_bins);
+
+typedef struct {
+	int fft_len;
+	int hop;
+	int n_bins;
+	double fs;
+	double * win;
+	fftw_plan plan;
+	// streaming path
+	double * scratch;
+	fftw_complex * spec;
+	sig_type * hist;
+	int fill;
+	sig_type * mag;
+	// output
+	long frame;
+	stft_cb cb;
+	void * cb_ctx;
+	FILE * fp;
+	float * fbuf;
+} stft_engine;
+
+/*
+ * function: stft_init
+ * purpose: allocates buffers, computes the analysis window and plans the FFT
+ * inputs: - stft_engine * SE
+ * 		   - int FFT_LEN
+ * 		   - int HOP (1 .. FFT_LEN)
+ * 		   - int WIN_TYPE
+ * 		   - double FS
+ * returns: 0 - success, -1 - failure
+ * Codes for int win_type: 0: Hanning, 1: Hamming, 2: Blackman, 3: Blackman-Harris
+ */
+int stft_init(stft_engine * se, int fft_len, int hop, int win_type, double fs);
+
+/*
+ * function: stft_set_callback
+ * purpose: sets the function that receives each magnitude frame
+ * inputs: - stft_engine * SE
+ * 		   - stft_cb CB
+ * 		   - void * CTX
+ * returns: 0 - success, -1 - failure
+ */
+int stft_set_callback(stft_engine * se, stft_cb cb, void * ctx);
+
+/*
+ * function: stft_open
+ * purpose: starts writing frames to a spectrogram file at PATH
+ * inputs: - stft_engine * SE
+ * 		   - char * PATH
+ * returns: 0 - success, -1 - failure
+ */
+int stft_open(stft_engine * se, char * path);
+
+/*
+ * function: stft_free
+ * purpose: closes the spectrogram file and releases the engine
+ * inputs: - stft_engine * SE
+ * returns: 0 - success, -1 - failure
+ */
+int stft_free(stft_engine * se);
+
+/*
+ * function: stft_push
+ * purpose: streams LEN samples into the engine, emitting a frame every HOP samples
+ * inputs: - stft_engine * SE
+ * 		   - sig_type * IN
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int stft_push(stft_engine * se, sig_type * in, int len);
+
+/*
+ * function: stft_batch
+ * purpose: spectrogram of a whole recorded capture over N_THREADS, frames
+ * 			emitted in order
+ * inputs: - stft_engine * SE
+ * 		   - sig_type * IN
+ * 		   - long LEN
+ * 		   - int N_THREADS (0: one per online core)
+ * returns: 0 - success, -1 - failure
+ */
+int stft_batch(stft_engine * se, sig_type * in, long len, int n_threads);
+
+#endif /* STFT_HELPER_H_ */
@@ -53,6 +53,10 @@ const double SR = 200.0;
 double *W;
 double *F;
 
+// FFT length in use (FFT_BUFFER by default), changed with fft_set_len
+int fft_len = FFT_BUFFER;
+int fft_halfbuff = FFT_HALFBUFF;
+
 // Pointers for FFTW buffers
 double *IN[OUT_NUM];
 fftw_complex *OUT[OUT_NUM];
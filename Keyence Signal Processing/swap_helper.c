@@ -0,0 +1,231 @@
+/*
+ * swap_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: double buffered filter coefficients that can be replaced while the
+ *      		 stream runs. A control thread designs taps off the hot path and
+ *      		 publishes them into the idle buffer; the filter thread picks them
+ *      		 up at the next sample boundary with one acquire load, no locks.
+ *      		 The idle buffer is only handed back once the filter thread has
+ *      		 acknowledged the switch (and finished any crossfade), so a
+ *      		 publisher never writes taps that are still being read.
+ *      		 With FOLD set (by swap_tune, which times both forms of the dot
+ *      		 product as swap_convolve runs it) linear phase tap sets are
+ *      		 convolved in folded form, half the multiplies.
+ */
+
+#include "swap_helper.h"
+
+/*
+ * function: swap_init
+ * purpose: allocates both coefficient buffers and makes TAPS the live set
+ * inputs: - coef_swap * CS
+ * 		   - int CAP (largest tap count that will ever be published)
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int swap_init(coef_swap * cs, int cap, double * taps, int len) {
+	if (cs == NULL || taps == NULL || len < 1 || len > cap) {
+		printf("Error: swap_init invalid parameters!\n");
+		return -1;
+	}
+	memset(cs, 0, sizeof(coef_swap));
+	cs->taps[0] = (double *) calloc(cap, sizeof(double));
+	cs->taps[1] = (double *) calloc(cap, sizeof(double));
+	if (cs->taps[0] == NULL || cs->taps[1] == NULL ) {
+		free(cs->taps[0]);
+		free(cs->taps[1]);
+		printf("Error: swap_init failed mem allocation!\n");
+		return -1;
+	}
+	memcpy(cs->taps[0], taps, sizeof(double) * len);
+	cs->len[0] = len;
+	cs->sym[0] = tune_symmetric(taps, len);
+	cs->cap = cap;
+	atomic_init(&cs->pub, 0);
+	atomic_init(&cs->seq, 0);
+	atomic_init(&cs->ack, 0);
+	return 0;
+} /* int swap_init */
+
+/*
+ * function: swap_free
+ * purpose: releases both coefficient buffers
+ * inputs: - coef_swap * CS
+ * returns: 0 - success, -1 - failure
+ */
+int swap_free(coef_swap * cs) {
+	if (cs == NULL )
+		return -1;
+	free(cs->taps[0]);
+	free(cs->taps[1]);
+	cs->taps[0] = NULL;
+	cs->taps[1] = NULL;
+	return 0;
+} /* int swap_free */
+
+/*
+ * function: swap_publish
+ * purpose: copies TAPS into the idle buffer and publishes it. The filter thread
+ * 			switches at its next sample, fading from the old taps to the new
+ * 			ones over XFADE samples (0 switches immediately). Call from a single
+ * 			control thread; never blocks.
+ * inputs: - coef_swap * CS
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * 		   - int XFADE
+ * returns: 0 - success, 1 - previous swap still in progress, retry later, -1 - failure
+ */
+int swap_publish(coef_swap * cs, double * taps, int len, int xfade) {
+	if (cs == NULL || taps == NULL || len < 1 || len > cs->cap || xfade < 0)
+		return -1;
+
+	unsigned int seq = atomic_load_explicit(&cs->seq, memory_order_relaxed);
+	if (atomic_load_explicit(&cs->ack, memory_order_acquire) != seq)
+		return 1;
+
+	int idle = 1 - atomic_load_explicit(&cs->pub, memory_order_relaxed);
+	memcpy(cs->taps[idle], taps, sizeof(double) * len);
+	cs->len[idle] = len;
+	cs->sym[idle] = tune_symmetric(taps, len);
+	cs->xfade[idle] = xfade;
+	atomic_store_explicit(&cs->pub, idle, memory_order_relaxed);
+	atomic_store_explicit(&cs->seq, seq + 1, memory_order_release);
+	return 0;
+} /* int swap_publish */
+
+// dot product of TAPS with the newest LEN samples of FB, per channel.
+// FOLD pairs the samples that share a tap of a symmetric set
+static void swap_dot(double * taps, int len, int fold, sig_type * fb,
+		int fb_len, double * acc) {
+	int k, j;
+	sig_type * x = fb + (fb_len - len);
+	for (j = 0; j < OUT_NUM; j++)
+		acc[j] = 0.0;
+	if (!fold) {
+		for (k = 0; k < len; k++)
+			for (j = 0; j < OUT_NUM; j++)
+				acc[j] += taps[k] * x[k][j];
+		return;
+	}
+	for (k = 0; k < len / 2; k++)
+		for (j = 0; j < OUT_NUM; j++)
+			acc[j] += taps[k] * (x[k][j] + x[len - 1 - k][j]);
+	if (len % 2)
+		for (j = 0; j < OUT_NUM; j++)
+			acc[j] += taps[len / 2] * x[len / 2][j];
+}
+
+/*
+ * function: swap_tune
+ * purpose: times swap_dot with the live taps in direct and folded form, one
+ * 			call per sample over a window sliding through FB_LEN samples as
+ * 			the running buffer does, and sets FOLD to the faster one. Call
+ * 			before the stream starts. Taps that are not symmetric never fold.
+ * 			The choice is cached in <CACHE>.tune as tune_select does, at
+ * 			block 1, folded as TUNE_SYMMETRIC and direct as TUNE_DIRECT.
+ * inputs: - coef_swap * CS
+ * 		   - int FB_LEN (>= CAP)
+ * 		   - char * CACHE (file prefix, NULL: no caching)
+ * returns: 1 - folded, 0 - direct, -1 - failure
+ */
+int swap_tune(coef_swap * cs, int fb_len, char * cache) {
+	if (cs == NULL || cs->taps[0] == NULL || fb_len < cs->cap) {
+		printf("Error: swap_tune invalid parameters!\n");
+		return -1;
+	}
+	int cur = cs->cur;
+	cs->fold = 0;
+	if (!cs->sym[cur])
+		return 0;
+	int impl = tune_cache_find(cache, cs->taps[cur], cs->len[cur], 1);
+	if (impl == TUNE_DIRECT || impl == TUNE_SYMMETRIC) {
+		cs->fold = (impl == TUNE_SYMMETRIC);
+		return cs->fold;
+	}
+
+	int n = TUNE_BENCH_SAMPLES;
+	sig_type * x = (sig_type *) malloc(sizeof(sig_type) * ((size_t) fb_len + n));
+	if (x == NULL ) {
+		printf("Error: swap_tune failed mem allocation!\n");
+		return -1;
+	}
+	uint32_t seed = 12345;
+	int i, j, r, fold;
+	for (i = 0; i < fb_len + n; i++) {
+		for (j = 0; j < OUT_NUM; j++) {
+			seed = seed * 1664525u + 1013904223u;
+			x[i][j] = (seed >> 8) / 8388608.0 - 1.0;
+		}
+	}
+	double ns[2] = { -1.0, -1.0 };
+	double acc[OUT_NUM];
+	volatile double sink = 0.0;
+	for (r = 0; r < TUNE_BENCH_REPS; r++) {
+		for (fold = 0; fold < 2; fold++) {
+			struct timespec t0, t1;
+			clock_gettime(CLOCK_MONOTONIC, &t0);
+			for (i = 0; i < n; i++) {
+				swap_dot(cs->taps[cur], cs->len[cur], fold, x + i, fb_len, acc);
+				sink += acc[0];
+			}
+			clock_gettime(CLOCK_MONOTONIC, &t1);
+			double el = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / n;
+			ns[fold] = (ns[fold] < 0.0 || el < ns[fold]) ? el : ns[fold];
+		}
+	}
+	free(x);
+	(void) sink;
+	cs->fold = (ns[1] < ns[0]);
+	if (cache != NULL )
+		tune_cache_store(cache, cs->taps[cur], cs->len[cur], 1,
+				cs->fold ? TUNE_SYMMETRIC : TUNE_DIRECT, ns[cs->fold]);
+	return cs->fold;
+} /* int swap_tune */
+
+/*
+ * function: swap_convolve
+ * purpose: filter thread side. Picks up newly published taps at this sample
+ * 			boundary, then convolves the live taps with the running buffer FB
+ * 			(oldest sample first). While crossfading, the old and new outputs are
+ * 			blended linearly.
+ * inputs: - coef_swap * CS
+ * 		   - sig_type * FB
+ * 		   - int FB_LEN (>= CAP)
+ * 		   - double * OUTPUT (OUT_NUM values)
+ * returns: 0 - success, -1 - failure
+ */
+int swap_convolve(coef_swap * cs, sig_type * fb, int fb_len, double * output) {
+	if (cs == NULL || cs->taps[0] == NULL || fb_len < cs->cap)
+		return -1;
+
+	unsigned int seq = atomic_load_explicit(&cs->seq, memory_order_acquire);
+	if (seq != cs->cur_seq) {
+		cs->old = cs->cur;
+		cs->cur = atomic_load_explicit(&cs->pub, memory_order_relaxed);
+		cs->cur_seq = seq;
+		cs->xfade_pos = cs->xfade[cs->cur];
+		if (cs->xfade_pos == 0)
+			atomic_store_explicit(&cs->ack, seq, memory_order_release);
+	}
+
+	swap_dot(cs->taps[cs->cur], cs->len[cs->cur], cs->fold && cs->sym[cs->cur],
+			fb, fb_len, output);
+	if (cs->xfade_pos == 0)
+		return 0;
+
+	double prev[OUT_NUM];
+	swap_dot(cs->taps[cs->old], cs->len[cs->old], cs->fold && cs->sym[cs->old],
+			fb, fb_len, prev);
+	double a = (double) cs->xfade_pos / (cs->xfade[cs->cur] + 1);
+	int j;
+	for (j = 0; j < OUT_NUM; j++)
+		output[j] = a * prev[j] + (1.0 - a) * output[j];
+
+	// old taps stay readable until the fade completes
+	if (--cs->xfade_pos == 0)
+		atomic_store_explicit(&cs->ack, cs->cur_seq, memory_order_release);
+	return 0;
+} /* int swap_convolve */
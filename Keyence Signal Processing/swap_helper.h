@@ -0,0 +1,87 @@
+/*
+ * swap_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SWAP_HELPER_H_
+#define SWAP_HELPER_H_
+
+#include <stdatomic.h>
+#include "tune_helper.h"
+
+typedef struct {
+	// shared, written by the publisher
+	double * taps[2];
+	int len[2];
+	int sym[2];
+	int xfade[2];
+	int cap;
+	atomic_int pub;
+	atomic_uint seq;
+	// shared, written by the filter thread
+	atomic_uint ack;
+	// filter thread only, FOLD is set (swap_tune) before the stream starts
+	int fold;
+	int cur;
+	int old;
+	unsigned int cur_seq;
+	int xfade_pos;
+} coef_swap;
+
+/*
+ * function: swap_init
+ * purpose: allocates both coefficient buffers and makes TAPS the live set
+ * inputs: - coef_swap * CS
+ * 		   - int CAP
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int swap_init(coef_swap * cs, int cap, double * taps, int len);
+
+/*
+ * function: swap_free
+ * purpose: releases both coefficient buffers
+ * inputs: - coef_swap * CS
+ * returns: 0 - success, -1 - failure
+ */
+int swap_free(coef_swap * cs);
+
+/*
+ * function: swap_publish
+ * purpose: control thread side. Copies TAPS into the idle buffer and publishes
+ * 			it, optionally crossfading over XFADE samples. Never blocks.
+ * inputs: - coef_swap * CS
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * 		   - int XFADE
+ * returns: 0 - success, 1 - previous swap still in progress, retry later, -1 - failure
+ */
+int swap_publish(coef_swap * cs, double * taps, int len, int xfade);
+
+/*
+ * function: swap_tune
+ * purpose: times the direct and folded dot product of the live taps as
+ * 			swap_convolve runs them and sets FOLD to the faster, cached per
+ * 			machine in <CACHE>.tune
+ * inputs: - coef_swap * CS
+ * 		   - int FB_LEN
+ * 		   - char * CACHE (NULL: no caching)
+ * returns: 1 - folded, 0 - direct, -1 - failure
+ */
+int swap_tune(coef_swap * cs, int fb_len, char * cache);
+
+/*
+ * function: swap_convolve
+ * purpose: filter thread side. Switches taps at this sample boundary if new ones
+ * 			were published, then convolves them with the running buffer FB.
+ * inputs: - coef_swap * CS
+ * 		   - sig_type * FB
+ * 		   - int FB_LEN
+ * 		   - double * OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int swap_convolve(coef_swap * cs, sig_type * fb, int fb_len, double * output);
+
+#endif /* SWAP_HELPER_H_ */
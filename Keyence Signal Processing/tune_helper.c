@@ -0,0 +1,452 @@
+/*
+ * tune_helper.c
+ *
+ *   Created on: Oct 19, 2026
+ *
+ *      Summary: FIR implementations with the same response, and a startup
+ *      		 autotuner that picks the fastest for a tap set and block size
+ *      		 on this host.
+ *
+ *      		   TUNE_DIRECT     one multiply-add per tap
+ *      		   TUNE_SYMMETRIC  linear phase taps (h[k] = h[L - 1 - k]) folded,
+ *      		                   half the multiplies
+ *      		   TUNE_FFT        overlap-save FFT convolution on cached plans,
+ *      		                   a block of up to N - L + 1 samples per FFT
+ *
+ *      		 All three start from zero history and produce the same samples
+ *      		 with no added latency, so the choice is invisible downstream.
+ *      		 tune_select checks every candidate against TUNE_DIRECT before
+ *      		 timing it. The winner is cached in <CACHE>.tune, keyed by host,
+ *      		 tap count, block and a hash of the taps, and FFTW wisdom goes to
+ *      		 <CACHE>.wisdom, so later starts on the same machine skip both
+ *      		 the benchmark and the FFTW measurements.
+ *
+ *      		 A NAN input spoils a whole TUNE_FFT block rather than LEN outputs.
+ */
+
+#include "tune_helper.h"
+
+static const char * tune_names[TUNE_N_IMPL] = { "direct", "symmetric", "fft" };
+
+/*
+ * function: tune_symmetric
+ * purpose: tests whether taps are linear phase
+ * inputs: - double * TAPS
+ * 		   - int LEN
+ * returns: 1 - symmetric, 0 - not
+ */
+int tune_symmetric(double * taps, int len) {
+	double big = 0.0;
+	int k;
+	for (k = 0; k < len; k++)
+		big = (fabs(taps[k]) > big) ? fabs(taps[k]) : big;
+	for (k = 0; k < len / 2; k++)
+		if (fabs(taps[k] - taps[len - 1 - k]) > 1e-12 * big)
+			return 0;
+	return 1;
+} /* int tune_symmetric */
+
+/*
+ * function: tune_init
+ * purpose: sets up one implementation of the FIR TAPS. BLOCK sizes the FFT
+ * 			so a block normally needs a single transform.
+ * inputs: - tune_filt * TF
+ * 		   - int IMPL (TUNE_DIRECT, TUNE_SYMMETRIC, TUNE_FFT)
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * 		   - int BLOCK
+ * returns: 0 - success, -1 - failure
+ */
+int tune_init(tune_filt * tf, int impl, double * taps, int len, int block) {
+	if (tf == NULL || taps == NULL || len < 1 || block < 1 || impl < 0
+			|| impl >= TUNE_N_IMPL
+			|| (impl == TUNE_SYMMETRIC && !tune_symmetric(taps, len))) {
+		printf("Error: tune_init invalid parameters!\n");
+		return -1;
+	}
+	memset(tf, 0, sizeof(tune_filt));
+	tf->impl = impl;
+	tf->len = len;
+	int k;
+	if (impl != TUNE_FFT) {
+		tf->rtaps = (double *) malloc(sizeof(double) * len);
+		tf->hist = (double *) calloc((size_t) 2 * len * OUT_NUM, sizeof(double));
+		if (tf->rtaps == NULL || tf->hist == NULL ) {
+			printf("Error: tune_init failed mem allocation!\n");
+			return -1;
+		}
+		for (k = 0; k < len; k++)
+			tf->rtaps[k] = taps[len - 1 - k];
+		return 0;
+	}
+
+	int n = 2;
+	while (n < 2 * len || n < len - 1 + block)
+		n *= 2;
+	int bins = n / 2 + 1;
+	tf->n_fft = n;
+	tf->chunk = n - len + 1;
+	tf->frame = (double *) fftw_malloc(sizeof(sig_type) * n);
+	tf->y = (double *) fftw_malloc(sizeof(sig_type) * n);
+	tf->spec = (fftw_complex *) fftw_malloc(sizeof(fftw_complex) * bins * OUT_NUM);
+	tf->resp = (fftw_complex *) fftw_malloc(sizeof(fftw_complex) * bins);
+	double * h = (double *) fftw_malloc(sizeof(double) * n);
+	if (tf->frame == NULL || tf->y == NULL || tf->spec == NULL || tf->resp == NULL
+			|| h == NULL ) {
+		fftw_free(h);
+		printf("Error: tune_init failed mem allocation!\n");
+		return -1;
+	}
+	memset(tf->frame, 0, sizeof(sig_type) * n);
+
+	// response of the zero padded taps, with the 1 / N of the inverse folded in
+	fftw_plan hp = plan_get(n, PLAN_R2C, 1, 1);
+	tf->fwd = plan_get(n, PLAN_R2C, OUT_NUM, OUT_NUM);
+	tf->inv = plan_get(n, PLAN_C2R, OUT_NUM, OUT_NUM);
+	if (hp == NULL || tf->fwd == NULL || tf->inv == NULL ) {
+		fftw_free(h);
+		return -1;
+	}
+	memset(h, 0, sizeof(double) * n);
+	for (k = 0; k < len; k++)
+		h[k] = taps[k] / n;
+	fftw_execute_dft_r2c(hp, h, tf->resp);
+	fftw_free(h);
+	return 0;
+} /* int tune_init */
+
+/*
+ * function: tune_free
+ * purpose: releases memory held by a tune_filt (cached plans stay)
+ * inputs: - tune_filt * TF
+ * returns: 0 - success, -1 - failure
+ */
+int tune_free(tune_filt * tf) {
+	if (tf == NULL )
+		return -1;
+	free(tf->rtaps);
+	free(tf->hist);
+	fftw_free(tf->frame);
+	fftw_free(tf->y);
+	fftw_free(tf->spec);
+	fftw_free(tf->resp);
+	memset(tf, 0, sizeof(tune_filt));
+	return 0;
+} /* int tune_free */
+
+// direct and folded forms, one sample
+static void tune_sample(tune_filt * tf, sig_type input, sig_type output) {
+	int L = tf->len;
+	int j, k;
+	double * h0 = tf->hist + (size_t) tf->pos * OUT_NUM;
+	double * h1 = tf->hist + (size_t) (tf->pos + L) * OUT_NUM;
+	for (j = 0; j < OUT_NUM; j++) {
+		h0[j] = input[j];
+		h1[j] = input[j];
+	}
+	tf->pos = (tf->pos + 1 == L) ? 0 : tf->pos + 1;
+
+	double acc[OUT_NUM] = { 0.0 };
+	double * x = tf->hist + (size_t) tf->pos * OUT_NUM;
+	if (tf->impl == TUNE_DIRECT) {
+		for (k = 0; k < L; k++)
+			for (j = 0; j < OUT_NUM; j++)
+				acc[j] += tf->rtaps[k] * x[k * OUT_NUM + j];
+	} else {
+		double * xr = x + (size_t) (L - 1) * OUT_NUM;
+		for (k = 0; k < L / 2; k++)
+			for (j = 0; j < OUT_NUM; j++)
+				acc[j] += tf->rtaps[k] * (x[k * OUT_NUM + j] + xr[-k * OUT_NUM + j]);
+		if (L % 2)
+			for (j = 0; j < OUT_NUM; j++)
+				acc[j] += tf->rtaps[L / 2] * x[(L / 2) * OUT_NUM + j];
+	}
+	for (j = 0; j < OUT_NUM; j++)
+		output[j] = acc[j];
+}
+
+// overlap-save, M <= CHUNK samples through one forward and inverse FFT
+static void tune_fft_chunk(tune_filt * tf, sig_type * in, sig_type * out, int m) {
+	int L = tf->len;
+	int bins = tf->n_fft / 2 + 1;
+	sig_type * frame = (sig_type *) tf->frame;
+	sig_type * y = (sig_type *) tf->y;
+	int k, j;
+	memcpy(frame + (L - 1), in, sizeof(sig_type) * m);
+	// the tail only feeds discarded outputs, cleared so no stale NAN spreads
+	if (m < tf->chunk)
+		memset(frame + (L - 1 + m), 0, sizeof(sig_type) * (tf->chunk - m));
+	fftw_execute_dft_r2c(tf->fwd, tf->frame, tf->spec);
+	for (k = 0; k < bins; k++) {
+		double hr = tf->resp[k][0], hi = tf->resp[k][1];
+		for (j = 0; j < OUT_NUM; j++) {
+			double * c = tf->spec[k * OUT_NUM + j];
+			double re = c[0] * hr - c[1] * hi;
+			c[1] = c[0] * hi + c[1] * hr;
+			c[0] = re;
+		}
+	}
+	fftw_execute_dft_c2r(tf->inv, tf->spec, tf->y);
+	// outputs before L - 1 wrapped around the frame
+	memcpy(out, y + (L - 1), sizeof(sig_type) * m);
+	memmove(frame, frame + m, sizeof(sig_type) * (L - 1));
+}
+
+/*
+ * function: tune_block
+ * purpose: filters LEN samples. IN and OUT may alias.
+ * inputs: - tune_filt * TF
+ * 		   - sig_type * IN
+ * 		   - sig_type * OUT
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int tune_block(tune_filt * tf, sig_type * in, sig_type * out, int len) {
+	if (tf == NULL || in == NULL || out == NULL
+			|| (tf->hist == NULL && tf->frame == NULL ))
+		return -1;
+	int n;
+	if (tf->impl != TUNE_FFT) {
+		for (n = 0; n < len; n++)
+			tune_sample(tf, in[n], out[n]);
+		return 0;
+	}
+	for (n = 0; n < len; n += tf->chunk)
+		tune_fft_chunk(tf, in + n, out + n,
+				(len - n < tf->chunk) ? len - n : tf->chunk);
+	return 0;
+} /* int tune_block */
+
+/*
+ * function: tune_process
+ * purpose: filters one sample, as fir_process. INPUT and OUTPUT may alias.
+ * inputs: - tune_filt * TF
+ * 		   - sig_type INPUT
+ * 		   - sig_type OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int tune_process(tune_filt * tf, sig_type input, sig_type output) {
+	return tune_block(tf, (sig_type *) input, (sig_type *) output, 1);
+} /* int tune_process */
+
+// FNV-1a of the tap bytes, part of the cache key
+static uint64_t tune_hash(double * taps, int len) {
+	uint64_t h = 14695981039346656037ULL;
+	unsigned char * b = (unsigned char *) taps;
+	size_t i;
+	for (i = 0; i < sizeof(double) * len; i++) {
+		h ^= b[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+// runs IMPL over X in blocks, returns ns per sample (best of the reps) or -1.
+// *N is reduced to the samples filtered when the time budget runs out
+static double tune_time(int impl, double * taps, int len, int block, sig_type * x,
+		sig_type * y, int * n) {
+	double best = -1.0;
+	int r, b, i;
+	for (r = 0; r < TUNE_BENCH_REPS; r++) {
+		tune_filt tf;
+		memset(&tf, 0, sizeof(tune_filt));
+		if (tune_init(&tf, impl, taps, len, block) == -1) {
+			tune_free(&tf);
+			return -1.0;
+		}
+		struct timespec t0, t1;
+		double el = 0.0;
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		for (b = 0, i = 0; b < *n; b += block, i++) {
+			tune_block(&tf, x + b, y + b, (*n - b < block) ? *n - b : block);
+			// the clock is read every 64 blocks to keep it out of the timing
+			if ((i & 63) == 63 || b + block >= *n) {
+				clock_gettime(CLOCK_MONOTONIC, &t1);
+				el = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+				if (el > TUNE_BENCH_NS) {
+					*n = (b + block < *n) ? b + block : *n;
+					break;
+				}
+			}
+		}
+		tune_free(&tf);
+		double ns = el / *n;
+		best = (best < 0.0 || ns < best) ? ns : best;
+	}
+	return best;
+}
+
+/*
+ * function: tune_cache_find
+ * purpose: looks up the implementation cached in <CACHE>.tune for TAPS at
+ * 			BLOCK samples per call on this host. Lines read
+ * 			"<host> <len> <block> <hash> <impl> <ns>". A TUNE_SYMMETRIC entry
+ * 			only matches symmetric taps.
+ * inputs: - char * CACHE
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * 		   - int BLOCK
+ * returns: cached TUNE_DIRECT, TUNE_SYMMETRIC or TUNE_FFT, -1 - none
+ */
+int tune_cache_find(char * cache, double * taps, int len, int block) {
+	if (cache == NULL || taps == NULL || len < 1 || block < 1)
+		return -1;
+	char host[64] = "localhost";
+	char path[TUNE_PATH_LEN], line[TUNE_PATH_LEN];
+	gethostname(host, sizeof(host) - 1);
+	host[sizeof(host) - 1] = '\0';
+	uint64_t hash = tune_hash(taps, len);
+	snprintf(path, sizeof(path), "%s.tune", cache);
+
+	FILE * fp = fopen(path, "r");
+	if (fp == NULL )
+		return -1;
+	while (fgets(line, sizeof(line), fp) != NULL ) {
+		char h[64];
+		int l, b, impl;
+		unsigned long long k;
+		if (sscanf(line, "%63s %d %d %llx %d", h, &l, &b, &k, &impl) == 5
+				&& strcmp(h, host) == 0 && l == len && b == block
+				&& k == hash && impl >= 0 && impl < TUNE_N_IMPL
+				&& (impl != TUNE_SYMMETRIC || tune_symmetric(taps, len))) {
+			fclose(fp);
+			return impl;
+		}
+	}
+	fclose(fp);
+	return -1;
+} /* int tune_cache_find */
+
+/*
+ * function: tune_cache_store
+ * purpose: appends the choice IMPL for TAPS at BLOCK samples per call on this
+ * 			host to <CACHE>.tune, with its time NS per sample
+ * inputs: - char * CACHE
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * 		   - int BLOCK
+ * 		   - int IMPL
+ * 		   - double NS
+ * returns: 0 - success, -1 - failure
+ */
+int tune_cache_store(char * cache, double * taps, int len, int block, int impl,
+		double ns) {
+	if (cache == NULL || taps == NULL || len < 1 || block < 1 || impl < 0
+			|| impl >= TUNE_N_IMPL) {
+		printf("Error: tune_cache_store invalid parameters!\n");
+		return -1;
+	}
+	char host[64] = "localhost";
+	char path[TUNE_PATH_LEN];
+	gethostname(host, sizeof(host) - 1);
+	host[sizeof(host) - 1] = '\0';
+	snprintf(path, sizeof(path), "%s.tune", cache);
+
+	FILE * fp = fopen(path, "a");
+	if (fp == NULL ) {
+		printf("Error: tune_cache_store cannot open %s!\n", path);
+		return -1;
+	}
+	fprintf(fp, "%s %d %d %016llx %d %.1f\n", host, len, block,
+			(unsigned long long) tune_hash(taps, len), impl, ns);
+	fclose(fp);
+	return 0;
+} /* int tune_cache_store */
+
+/*
+ * function: tune_select
+ * purpose: picks the fastest implementation of TAPS at BLOCK samples per call
+ * 			on this host. A cached choice from <CACHE>.tune is used if there is
+ * 			one; otherwise every candidate is checked against TUNE_DIRECT (to
+ * 			TOL relative to sum |taps|), timed, and the winner appended to the
+ * 			cache. FFTW wisdom is loaded from and saved to <CACHE>.wisdom.
+ * 			TUNE_FFT is no candidate at BLOCK 1.
+ * inputs: - double * TAPS
+ * 		   - int LEN
+ * 		   - int BLOCK
+ * 		   - double TOL
+ * 		   - char * CACHE (file prefix, NULL: no caching)
+ * returns: TUNE_DIRECT, TUNE_SYMMETRIC or TUNE_FFT, -1 - failure
+ */
+int tune_select(double * taps, int len, int block, double tol, char * cache) {
+	if (taps == NULL || len < 1 || block < 1 || tol <= 0.0) {
+		printf("Error: tune_select invalid parameters!\n");
+		return -1;
+	}
+	char wis_path[TUNE_PATH_LEN];
+	int impl;
+
+	if (cache != NULL ) {
+		snprintf(wis_path, sizeof(wis_path), "%s.wisdom", cache);
+		plan_wisdom_load(wis_path);
+		impl = tune_cache_find(cache, taps, len, block);
+		if (impl >= 0 && (impl != TUNE_FFT || block > 1))
+			return impl;
+	}
+
+	// deterministic broadband test signal, unit amplitude
+	int n = (TUNE_BENCH_SAMPLES > 4 * block) ? TUNE_BENCH_SAMPLES : 4 * block;
+	sig_type * x = (sig_type *) malloc(sizeof(sig_type) * n);
+	sig_type * ref = (sig_type *) malloc(sizeof(sig_type) * n);
+	sig_type * y = (sig_type *) malloc(sizeof(sig_type) * n);
+	if (x == NULL || ref == NULL || y == NULL ) {
+		free(x);
+		free(ref);
+		free(y);
+		printf("Error: tune_select failed mem allocation!\n");
+		return -1;
+	}
+	uint32_t seed = 12345;
+	int i, j;
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < OUT_NUM; j++) {
+			seed = seed * 1664525u + 1013904223u;
+			x[i][j] = (seed >> 8) / 8388608.0 - 1.0;
+		}
+	}
+	double bound = 0.0;
+	for (i = 0; i < len; i++)
+		bound += fabs(taps[i]);
+	bound *= tol;
+
+	double ns[TUNE_N_IMPL];
+	int best = TUNE_DIRECT;
+	int m = n;
+	ns[TUNE_DIRECT] = tune_time(TUNE_DIRECT, taps, len, block, x, ref, &m);
+	int n_ref = m;
+	for (impl = TUNE_DIRECT + 1; impl < TUNE_N_IMPL; impl++) {
+		ns[impl] = -1.0;
+		if (impl == TUNE_SYMMETRIC && !tune_symmetric(taps, len))
+			continue;
+		// one sample per call never fills an FFT block
+		if (impl == TUNE_FFT && block == 1)
+			continue;
+		m = n;
+		if ((ns[impl] = tune_time(impl, taps, len, block, x, y, &m)) < 0.0)
+			continue;
+		// the reference may have stopped early too
+		double err = 0.0;
+		for (i = 0; i < m && i < n_ref; i++)
+			for (j = 0; j < OUT_NUM; j++)
+				err = (fabs(y[i][j] - ref[i][j]) > err) ? fabs(y[i][j] - ref[i][j]) : err;
+		if (!(err <= bound)) {
+			printf("Warning: tune_select %s off by %g, not used!\n", tune_names[impl],
+					err);
+			ns[impl] = -1.0;
+			continue;
+		}
+		if (ns[impl] < ns[best])
+			best = impl;
+	}
+	free(x);
+	free(ref);
+	free(y);
+	if (ns[TUNE_DIRECT] < 0.0)
+		return -1;
+
+	if (cache != NULL ) {
+		tune_cache_store(cache, taps, len, block, best, ns[best]);
+		plan_wisdom_save(wis_path);
+	}
+	return best;
+} /* int tune_select */
@@ -0,0 +1,141 @@
+/*
+ * tune_helper.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef TUNE_HELPER_H_
+#define TUNE_HELPER_H_
+
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "plan_helper.h"
+
+#define TUNE_DIRECT 0
+#define TUNE_SYMMETRIC 1
+#define TUNE_FFT 2
+#define TUNE_N_IMPL 3
+
+#define TUNE_CACHE "keyence"
+// agreement with TUNE_DIRECT, relative to sum |taps| for a unit input
+#define TUNE_TOL 1e-9
+#define TUNE_BENCH_SAMPLES 32768
+#define TUNE_BENCH_REPS 3
+// a candidate far slower than the others stops early, after this long per rep
+#define TUNE_BENCH_NS 50e6
+#define TUNE_PATH_LEN 256
+
+typedef struct {
+	int impl;
+	int len;
+	// taps reversed, history stored twice (ring written at pos and pos + LEN)
+	double * rtaps;
+	double * hist;
+	int pos;
+	// TUNE_FFT: frame holds LEN - 1 samples of history then up to CHUNK new ones
+	int n_fft;
+	int chunk;
+	double * frame;
+	double * y;
+	fftw_complex * spec;
+	fftw_complex * resp;
+	fftw_plan fwd;
+	fftw_plan inv;
+} tune_filt;
+
+/*
+ * function: tune_symmetric
+ * purpose: tests whether taps are linear phase
+ * inputs: - double * TAPS
+ * 		   - int LEN
+ * returns: 1 - symmetric, 0 - not
+ */
+int tune_symmetric(double * taps, int len);
+
+/*
+ * function: tune_init
+ * purpose: sets up one implementation (TUNE_DIRECT, TUNE_SYMMETRIC, TUNE_FFT)
+ * 			of the FIR TAPS for blocks of BLOCK samples
+ * inputs: - tune_filt * TF
+ * 		   - int IMPL
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * 		   - int BLOCK
+ * returns: 0 - success, -1 - failure
+ */
+int tune_init(tune_filt * tf, int impl, double * taps, int len, int block);
+
+/*
+ * function: tune_free
+ * purpose: releases memory held by a tune_filt
+ * inputs: - tune_filt * TF
+ * returns: 0 - success, -1 - failure
+ */
+int tune_free(tune_filt * tf);
+
+/*
+ * function: tune_block
+ * purpose: filters LEN samples. IN and OUT may alias.
+ * inputs: - tune_filt * TF
+ * 		   - sig_type * IN
+ * 		   - sig_type * OUT
+ * 		   - int LEN
+ * returns: 0 - success, -1 - failure
+ */
+int tune_block(tune_filt * tf, sig_type * in, sig_type * out, int len);
+
+/*
+ * function: tune_process
+ * purpose: filters one sample. INPUT and OUTPUT may alias.
+ * inputs: - tune_filt * TF
+ * 		   - sig_type INPUT
+ * 		   - sig_type OUTPUT
+ * returns: 0 - success, -1 - failure
+ */
+int tune_process(tune_filt * tf, sig_type input, sig_type output);
+
+/*
+ * function: tune_cache_find
+ * purpose: implementation cached in <CACHE>.tune for TAPS at BLOCK samples
+ * 			per call on this host, keyed by host, tap count, block and a hash
+ * 			of the taps
+ * inputs: - char * CACHE
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * 		   - int BLOCK
+ * returns: cached TUNE_DIRECT, TUNE_SYMMETRIC or TUNE_FFT, -1 - none
+ */
+int tune_cache_find(char * cache, double * taps, int len, int block);
+
+/*
+ * function: tune_cache_store
+ * purpose: appends the choice IMPL (NS per sample) for TAPS at BLOCK samples
+ * 			per call on this host to <CACHE>.tune
+ * inputs: - char * CACHE
+ * 		   - double * TAPS
+ * 		   - int LEN
+ * 		   - int BLOCK
+ * 		   - int IMPL
+ * 		   - double NS
+ * returns: 0 - success, -1 - failure
+ */
+int tune_cache_store(char * cache, double * taps, int len, int block, int impl,
+		double ns);
+
+/*
+ * function: tune_select
+ * purpose: fastest implementation of TAPS at BLOCK samples per call on this
+ * 			host, checked against the direct form to TOL and cached per
+ * 			machine in <CACHE>.tune next to the FFTW wisdom in <CACHE>.wisdom.
+ * 			TUNE_FFT is no candidate at BLOCK 1.
+ * inputs: - double * TAPS
+ * 		   - int LEN
+ * 		   - int BLOCK
+ * 		   - double TOL
+ * 		   - char * CACHE (NULL: no caching)
+ * returns: TUNE_DIRECT, TUNE_SYMMETRIC or TUNE_FFT, -1 - failure
+ */
+int tune_select(double * taps, int len, int block, double tol, char * cache);
+
+#endif /* TUNE_HELPER_H_ */